@@ -0,0 +1,109 @@
+// Copyright d/Dev 2026
+
+#include "BPAsyncRequestAction.h"
+
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+
+#include "BPLogging.h"
+#include "BPDeviceSubsystem.h"
+
+UBPAsyncRequestAction* UBPAsyncRequestAction::Create(UObject* WorldContextObject, TFunction<TFuture<FInstancedStruct>(UBPDeviceSubsystem&)>&& InRequest)
+{
+	UBPAsyncRequestAction* Action = NewObject<UBPAsyncRequestAction>();
+	Action->Request = MoveTemp(InRequest);
+	if (UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull))
+	{
+		if (UGameInstance* GameInstance = World->GetGameInstance())
+		{
+			Action->Subsystem = GameInstance->GetSubsystem<UBPDeviceSubsystem>();
+		}
+	}
+	Action->RegisterWithGameInstance(WorldContextObject);
+	return Action;
+}
+
+void UBPAsyncRequestAction::Activate()
+{
+	UBPDeviceSubsystem* DeviceSubsystem = Subsystem.Get();
+	if (DeviceSubsystem == nullptr)
+	{
+		BPLog::Error(this, "Could not find the Device Subsystem for an async request!");
+		HandleResponse(FInstancedStruct::Make<FBPMessageStatusError>(-1, FString("No Device Subsystem."), EBPErrorCode::ERROR_UNKNOWN));
+		return;
+	}
+
+	//The subsystem always resolves the future (on response, timeout or disconnect), but we may have been destroyed by then.
+	TWeakObjectPtr<UBPAsyncRequestAction> WeakThis(this);
+	Request(*DeviceSubsystem).Then([WeakThis](TFuture<FInstancedStruct> Response)
+	{
+		if (UBPAsyncRequestAction* This = WeakThis.Get())
+		{
+			This->HandleResponse(Response.Get());
+		}
+	});
+}
+
+void UBPAsyncRequestAction::HandleResponse(const FInstancedStruct& Response)
+{
+	if (Response.GetScriptStruct() == FBPMessageStatusError::StaticStruct())
+	{
+		OnError.Broadcast(Response);
+	}
+	else
+	{
+		OnResponse.Broadcast(Response);
+	}
+	SetReadyToDestroy();
+}
+
+UBPAsyncRequestAction* UBPAsyncRequestAction::RequestServerInfoAsync(UObject* WorldContextObject)
+{
+	return Create(WorldContextObject, [](UBPDeviceSubsystem& DeviceSubsystem) { return DeviceSubsystem.RequestServerInfoAsync(); });
+}
+
+UBPAsyncRequestAction* UBPAsyncRequestAction::PingServerAsync(UObject* WorldContextObject)
+{
+	return Create(WorldContextObject, [](UBPDeviceSubsystem& DeviceSubsystem) { return DeviceSubsystem.PingServerAsync(); });
+}
+
+UBPAsyncRequestAction* UBPAsyncRequestAction::RequestDeviceListAsync(UObject* WorldContextObject)
+{
+	return Create(WorldContextObject, [](UBPDeviceSubsystem& DeviceSubsystem) { return DeviceSubsystem.RequestDeviceListAsync(); });
+}
+
+UBPAsyncRequestAction* UBPAsyncRequestAction::StopDeviceAsync(UObject* WorldContextObject, const FBPDeviceObject& Device, bool bStopPatterns /*= true*/)
+{
+	return Create(WorldContextObject, [Device, bStopPatterns](UBPDeviceSubsystem& DeviceSubsystem) { return DeviceSubsystem.StopDeviceAsync(Device, bStopPatterns); });
+}
+
+UBPAsyncRequestAction* UBPAsyncRequestAction::StopAllDevicesAsync(UObject* WorldContextObject, bool bStopPatterns /*= true*/)
+{
+	return Create(WorldContextObject, [bStopPatterns](UBPDeviceSubsystem& DeviceSubsystem) { return DeviceSubsystem.StopAllDevicesAsync(bStopPatterns); });
+}
+
+UBPAsyncRequestAction* UBPAsyncRequestAction::StartScanningAsync(UObject* WorldContextObject)
+{
+	return Create(WorldContextObject, [](UBPDeviceSubsystem& DeviceSubsystem) { return DeviceSubsystem.StartScanningAsync(); });
+}
+
+UBPAsyncRequestAction* UBPAsyncRequestAction::StopScanningAsync(UObject* WorldContextObject)
+{
+	return Create(WorldContextObject, [](UBPDeviceSubsystem& DeviceSubsystem) { return DeviceSubsystem.StopScanningAsync(); });
+}
+
+UBPAsyncRequestAction* UBPAsyncRequestAction::SendScalarCommandAsync(UObject* WorldContextObject, const FBPScalarCommand& Command)
+{
+	return Create(WorldContextObject, [Command](UBPDeviceSubsystem& DeviceSubsystem) { return DeviceSubsystem.SendScalarCommandAsync(Command); });
+}
+
+UBPAsyncRequestAction* UBPAsyncRequestAction::SendLinearCommandAsync(UObject* WorldContextObject, const FBPLinearCommand& Command)
+{
+	return Create(WorldContextObject, [Command](UBPDeviceSubsystem& DeviceSubsystem) { return DeviceSubsystem.SendLinearCommandAsync(Command); });
+}
+
+UBPAsyncRequestAction* UBPAsyncRequestAction::SendRotateCommandAsync(UObject* WorldContextObject, const FBPRotateCommand& Command)
+{
+	return Create(WorldContextObject, [Command](UBPDeviceSubsystem& DeviceSubsystem) { return DeviceSubsystem.SendRotateCommandAsync(Command); });
+}
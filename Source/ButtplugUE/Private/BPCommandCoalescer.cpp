@@ -0,0 +1,157 @@
+// Copyright d/Dev 2026
+
+#include "BPCommandCoalescer.h"
+
+template<typename CommandType>
+int32 FBPCommandCoalescer::Merge(TArray<TPending<CommandType>>& Pending, const CommandType& Command, TFunctionRef<int32()> MakeId, bool& bOutMerged)
+{
+	TPending<CommandType>* Existing = Pending.FindByPredicate([&Command](const TPending<CommandType>& Other) { return Other.Command.DeviceIndex == Command.DeviceIndex; });
+	if (Existing == nullptr)
+	{
+		Existing = &Pending.AddDefaulted_GetRef();
+		Existing->Command.DeviceIndex = Command.DeviceIndex;
+	}
+	bOutMerged = Existing->NumSet > 0;
+	if (!bOutMerged)
+	{
+		Existing->Command.Id = MakeId();
+	}
+
+	//Last write wins, per actuator. Values are copied over the entry already there for that actuator, pending or left over.
+	auto& Merged = GetElements(Existing->Command);
+	for (const auto& Element : GetElements(Command))
+	{
+		int32 At = Merged.IndexOfByPredicate([&Element](const auto& Other) { return Other.Index == Element.Index; });
+		if (At == INDEX_NONE)
+		{
+			At = Merged.Add(Element);
+			Existing->Set.Add(false);
+		}
+		else
+		{
+			Merged[At] = Element;
+		}
+		if (!Existing->Set[At])
+		{
+			Existing->Set[At] = true;
+			Existing->NumSet++;
+		}
+	}
+	return Existing->Command.Id;
+}
+
+template<typename CommandType>
+void FBPCommandCoalescer::Unset(TArray<TPending<CommandType>>& Pending, const CommandType& Command)
+{
+	TPending<CommandType>* Existing = Pending.FindByPredicate([&Command](const TPending<CommandType>& Other) { return Other.Command.DeviceIndex == Command.DeviceIndex; });
+	if (Existing == nullptr)
+	{
+		return;
+	}
+
+	const auto& Remaining = GetElements(Existing->Command);
+	for (const auto& Element : GetElements(Command))
+	{
+		const int32 At = Remaining.IndexOfByPredicate([&Element](const auto& Other) { return Other.Index == Element.Index; });
+		if (At != INDEX_NONE && Existing->Set[At])
+		{
+			Existing->Set[At] = false;
+			Existing->NumSet--;
+		}
+	}
+}
+
+int32 FBPCommandCoalescer::Add(const FBPScalarCommand& Command, TFunctionRef<int32()> MakeId, bool& bOutMerged)
+{
+	return Merge(Scalars, Command, MakeId, bOutMerged);
+}
+
+int32 FBPCommandCoalescer::Add(const FBPLinearCommand& Command, TFunctionRef<int32()> MakeId, bool& bOutMerged)
+{
+	return Merge(Linears, Command, MakeId, bOutMerged);
+}
+
+int32 FBPCommandCoalescer::Add(const FBPRotateCommand& Command, TFunctionRef<int32()> MakeId, bool& bOutMerged)
+{
+	return Merge(Rotates, Command, MakeId, bOutMerged);
+}
+
+int32 FBPCommandCoalescer::Add(const FInstancedStruct& Command, TFunctionRef<int32()> MakeId, bool& bOutMerged)
+{
+	bOutMerged = false;
+	if (const FBPScalarCommand* Scalar = Command.GetPtr<FBPScalarCommand>())
+	{
+		return Add(*Scalar, MakeId, bOutMerged);
+	}
+	if (const FBPLinearCommand* Linear = Command.GetPtr<FBPLinearCommand>())
+	{
+		return Add(*Linear, MakeId, bOutMerged);
+	}
+	if (const FBPRotateCommand* Rotate = Command.GetPtr<FBPRotateCommand>())
+	{
+		return Add(*Rotate, MakeId, bOutMerged);
+	}
+	return -1;
+}
+
+void FBPCommandCoalescer::Remove(const FBPScalarCommand& Command)
+{
+	Unset(Scalars, Command);
+}
+
+void FBPCommandCoalescer::Remove(const FBPLinearCommand& Command)
+{
+	Unset(Linears, Command);
+}
+
+void FBPCommandCoalescer::Remove(const FBPRotateCommand& Command)
+{
+	Unset(Rotates, Command);
+}
+
+namespace
+{
+	template<typename PendingType, typename FunctionType>
+	void ForDevice(TArray<PendingType>& Pending, int32 DeviceIndex, FunctionType&& Function)
+	{
+		if (PendingType* Existing = Pending.FindByPredicate([DeviceIndex](const PendingType& Other) { return Other.Command.DeviceIndex == DeviceIndex; }))
+		{
+			Function(*Existing);
+		}
+	}
+}
+
+void FBPCommandCoalescer::RemoveDevice(int32 DeviceIndex)
+{
+	ForDevice(Scalars, DeviceIndex, [](auto& Pending) { Clear(Pending); });
+	ForDevice(Linears, DeviceIndex, [](auto& Pending) { Clear(Pending); });
+	ForDevice(Rotates, DeviceIndex, [](auto& Pending) { Clear(Pending); });
+}
+
+void FBPCommandCoalescer::Reset()
+{
+	for (TPending<FBPScalarCommand>& Pending : Scalars)
+	{
+		Clear(Pending);
+	}
+	for (TPending<FBPLinearCommand>& Pending : Linears)
+	{
+		Clear(Pending);
+	}
+	for (TPending<FBPRotateCommand>& Pending : Rotates)
+	{
+		Clear(Pending);
+	}
+}
+
+bool FBPCommandCoalescer::IsEmpty() const
+{
+	auto IsPending = [](const auto& Pending) { return Pending.NumSet > 0; };
+	return !Scalars.ContainsByPredicate(IsPending) && !Linears.ContainsByPredicate(IsPending) && !Rotates.ContainsByPredicate(IsPending);
+}
+
+bool FBPCommandCoalescer::IsPending(int32 DeviceIndex) const
+{
+	auto IsPendingFor = [DeviceIndex](const auto& Pending) { return Pending.NumSet > 0 && Pending.Command.DeviceIndex == DeviceIndex; };
+	return Scalars.ContainsByPredicate(IsPendingFor) || Linears.ContainsByPredicate(IsPendingFor) || Rotates.ContainsByPredicate(IsPendingFor);
+}
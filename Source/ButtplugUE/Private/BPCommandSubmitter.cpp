@@ -0,0 +1,61 @@
+// Copyright d/Dev 2026
+
+#include "BPCommandSubmitter.h"
+
+#include "BPOutboundThread.h"
+
+FBPCommandSubmitter::FBPCommandSubmitter(TWeakPtr<FBPOutboundThread, ESPMode::ThreadSafe> InOutbound)
+	: Outbound(MoveTemp(InOutbound))
+{
+}
+
+bool FBPCommandSubmitter::SetScalar(int32 DeviceIndex, int32 ActuatorIndex, double Scalar, FName ActuatorType)
+{
+	TSharedPtr<FBPOutboundThread, ESPMode::ThreadSafe> Pinned = Outbound.Pin();
+	if (!Pinned.IsValid())
+	{
+		return false;
+	}
+
+	FBPSubmittedValue Value;
+	Value.Type = EBPMessageType::ScalarCmd;
+	Value.DeviceIndex = DeviceIndex;
+	Value.ActuatorIndex = ActuatorIndex;
+	Value.Value = Scalar;
+	Value.ActuatorType = ActuatorType;
+	return Pinned->Submit(Value);
+}
+
+bool FBPCommandSubmitter::SetLinear(int32 DeviceIndex, int32 ActuatorIndex, double Position, int32 DurationMs)
+{
+	TSharedPtr<FBPOutboundThread, ESPMode::ThreadSafe> Pinned = Outbound.Pin();
+	if (!Pinned.IsValid())
+	{
+		return false;
+	}
+
+	FBPSubmittedValue Value;
+	Value.Type = EBPMessageType::LinearCmd;
+	Value.DeviceIndex = DeviceIndex;
+	Value.ActuatorIndex = ActuatorIndex;
+	Value.Value = Position;
+	Value.Duration = DurationMs;
+	return Pinned->Submit(Value);
+}
+
+bool FBPCommandSubmitter::SetRotate(int32 DeviceIndex, int32 ActuatorIndex, double Speed, bool bClockwise)
+{
+	TSharedPtr<FBPOutboundThread, ESPMode::ThreadSafe> Pinned = Outbound.Pin();
+	if (!Pinned.IsValid())
+	{
+		return false;
+	}
+
+	FBPSubmittedValue Value;
+	Value.Type = EBPMessageType::RotateCmd;
+	Value.DeviceIndex = DeviceIndex;
+	Value.ActuatorIndex = ActuatorIndex;
+	Value.Value = Speed;
+	Value.bClockwise = bClockwise;
+	return Pinned->Submit(Value);
+}
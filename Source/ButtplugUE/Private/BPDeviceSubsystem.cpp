@@ -6,182 +6,1145 @@
 #include "IWebSocketsManager.h"
 #include "TimerManager.h"
 #include "Engine/World.h"
+#include "Misc/CoreDelegates.h"
 
 #include "ButtplugUESettings.h"
 #include "BPLogging.h"
 #include "BPManagedCommand.h"
+#include "BPMessageRegistry.h"
+#include "BPPacketTemplate.h"
+#include "BPStats.h"
+
+namespace
+{
+	//Longest shutdown or disconnect will wait for queued packets to be handed to the socket.
+	constexpr double OutboundDrainSeconds = 0.5;
+}
 
 void UBPDeviceSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
-	Super::Initialize(Collection);
+	Super::Initialize(Collection);
+
+	OutboundThread = MakeShared<FBPOutboundThread, ESPMode::ThreadSafe>();
+	InboundThread = MakeUnique<FBPInboundThread>(this);
+	if (InboundThread->IsRunning())
+	{
+		InboundTickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UBPDeviceSubsystem::OnInboundTick));
+	}
+
+	FlushMode = UButtplugUESettings::GetOutboundFlushMode();
+	bRateLimit = UButtplugUESettings::GetRateLimitDevices();
+	MaxUnacked = UButtplugUESettings::GetMaxUnackedCommands();
+	LatencyTarget = UButtplugUESettings::GetCommandLatencyTargetSeconds();
+	//Only merging for its own sake. Rate limiting holds commands in the coalescer whatever this says, see SendCommand.
+	bCoalesceCommands = FlushMode != EBPOutboundFlushMode::Immediate && UButtplugUESettings::GetCoalesceCommands();
+	bSuppressRedundant = UButtplugUESettings::GetSuppressRedundantCommands();
+	Shadow.SetRefreshSeconds(UButtplugUESettings::GetRedundantCommandRefreshSeconds());
+	Shadow.SetUnconfirmedTimeout(UButtplugUESettings::GetResponseTimeoutSeconds());
+	if (FlushMode == EBPOutboundFlushMode::PostActorTick)
+	{
+		FlushHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UBPDeviceSubsystem::OnWorldPostActorTick);
+	}
+	else if (FlushMode == EBPOutboundFlushMode::EndOfFrame || bRateLimit)
+	{
+		//In Immediate mode this only releases held commands once their device is ready.
+		FlushHandle = FCoreDelegates::OnEndFrame.AddUObject(this, &UBPDeviceSubsystem::FlushOutbound);
+	}
+
+	FStringFormatNamedArguments Args;
+	Args.Add("Server", UButtplugUESettings::GetButtplugServer());
+	Args.Add("Port", UButtplugUESettings::GetButtplugPort());
+	FString Server = FString::Format(TEXT("{Server}:{Port}"), Args);
+
+	Socket = FWebSocketsModule::Get().CreateWebSocket(Server, "ws");
+
+	if (Socket.IsValid())
+	{
+		Socket->OnConnected().AddUObject(this, &UBPDeviceSubsystem::OnConnected);
+		Socket->OnConnectionError().AddUObject(this, &UBPDeviceSubsystem::OnConnectionError);
+		Socket->OnClosed().AddUObject(this, &UBPDeviceSubsystem::OnClosed);
+		Socket->OnRawMessage().AddUObject(this, &UBPDeviceSubsystem::OnRawMessage);
+		Socket->OnMessageSent().AddUObject(this, &UBPDeviceSubsystem::OnMessageSent);
+		OutboundThread->SetSocket(Socket);
+
+		if(UButtplugUESettings::GetAutoConnect())
+		{
+			BPLog::Message(this, "Attempting to Connect to Buttplug Server at: " + Server);
+			Socket->Connect();
+		}
+	}
+	else
+	{
+		BPLog::Error(this, "Failed to Create Socket for Buttplug Server at: {Server}!", Args);
+	}
+}
+
+void UBPDeviceSubsystem::Deinitialize()
+{
+	if (IsConnected())
+	{
+		Disconnect();
+	}
+
+	FWorldDelegates::OnWorldPostActorTick.Remove(FlushHandle);
+	FCoreDelegates::OnEndFrame.Remove(FlushHandle);
+
+	OutboundThread->Shutdown(OutboundDrainSeconds);
+	//A submitter elsewhere may keep the thread object alive a while longer, but not the socket.
+	OutboundThread->SetSocket(nullptr);
+	OutboundThread.Reset();
+	FTSTicker::GetCoreTicker().RemoveTicker(InboundTickHandle);
+	InboundThread->Shutdown();
+	InboundThread.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UBPDeviceSubsystem::IsConnected() const
+{
+	return Socket.IsValid() && Socket->IsConnected();
+}
+
+void UBPDeviceSubsystem::OnConnected()
+{
+	FStringFormatNamedArguments Args;
+	Args.Add("Server", UButtplugUESettings::GetButtplugServer());
+	Args.Add("Port", UButtplugUESettings::GetButtplugPort());
+	BPLog::Message(this, "Successfully Connected to Buttplug Server at: {Server}:{Port}. Requesting Server Info Handshake.", Args);
+
+	GetWorld()->GetTimerManager().SetTimer(ResponseTimeoutTimer, this, &UBPDeviceSubsystem::ExpireResponses, 0.25f, true);
+
+	//TODO Calling this here for now since it needs to be done to establish a viable connection.
+	OnMessageServerInfoReceived.AddDynamic(this, &UBPDeviceSubsystem::OnServerHandshake);
+	RequestServerInfo(FBPInstancedResponseDelegate());
+}
+
+void UBPDeviceSubsystem::OnConnectionError(const FString& Error)
+{
+	FStringFormatNamedArguments Args;
+	Args.Add("Server", UButtplugUESettings::GetButtplugServer());
+	Args.Add("Port", UButtplugUESettings::GetButtplugPort());
+	Args.Add("Error", Error);
+	BPLog::Error(this, "Failed to Connect to Buttplug Server at: {Server}:{Port}! Check that the Intiface Central is running and you have the right server address/port. Error Message: {Error}", Args);
+}
+
+void UBPDeviceSubsystem::OnClosed(int32 StatusCode, const FString& Reason, bool bWasClean)
+{
+	FlushInbound();
+	ServerPingTimer.Invalidate();
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(ResponseTimeoutTimer);
+	}
+
+	//Nothing sent on this connection will be answered now, and anything that does turn up later is from the old session.
+	TArray<FResponseTable::FEntry> Pending;
+	ResponseDelegates.Reset(Pending);
+	for (FResponseTable::FEntry& Entry : Pending)
+	{
+		FailResponse(Entry, "Connection closed before a response was received.");
+	}
+	//Any query waiters were failed above along with their request, what is left is cached answers from the old session.
+	Queries.Reset();
+	TArray<FSentTable::FEntry> Unanswered;
+	SentLog.Reset(Unanswered);
+
+	Outbound.Reset();
+	ForgetAllDevices();
+	DeviceFlows.Reset();
+	ReceiveBuffer.Reset();
+	bDiscardingFrame = false;
+	DiscardedFrameBytes = 0;
+	KnownDevices.Reset();
+	if (OutboundThread.IsValid())
+	{
+		OutboundThread->SetSocket(nullptr);
+		OutboundThread->SetDevices(KnownDevices);
+	}
+	FStringFormatNamedArguments Args;
+	Args.Add("StatusCode", StatusCode);
+	Args.Add("Reason", Reason);
+	Args.Add("WasClean", bWasClean);
+	BPLog::Message(this, "Connection to Buttplug Server Closed! Code: {StatusCode}, Reason: {Reason}, WasClean: {WasClean}", Args);
+	OnServerDisconnect.Broadcast();
+}
+
+void UBPDeviceSubsystem::OnFrameReceived(TConstArrayView<uint8> Frame)
+{
+	//Only pay for the FString conversion if someone is actually going to see it.
+	if (UButtplugUESettings::GetLoggingVerbosity() == EBPLogVerbosity::All)
+	{
+		FUTF8ToTCHAR Converted((const ANSICHAR*)Frame.GetData(), Frame.Num());
+		BPLog::Message(this, "Message Received: " + FString(Converted.Length(), Converted.Get()));
+	}
+
+	if (InboundThread->IsRunning())
+	{
+		//Who is listening is decided now, as the frame arrives, the same as it would be parsing inline.
+		InboundThread->Parse(Frame, GetWantedTypes());
+	}
+	else
+	{
+		OnMessage(Frame);
+	}
+}
+
+bool UBPDeviceSubsystem::OnInboundTick(float DeltaTime)
+{
+	DrainInbound(UButtplugUESettings::GetMaxInboundMessagesPerFrame());
+	return true;
+}
+
+void UBPDeviceSubsystem::DrainInbound(int32 MaxMessages)
+{
+	const int32 Skipped = InboundThread->TakeSkippedCount();
+	SkippedMessageCount += Skipped;
+
+	for (int32 Drained = 0; MaxMessages <= 0 || Drained < MaxMessages; Drained++)
+	{
+		FBPInboundRecord* Record = InboundThread->Peek();
+		if (Record == nullptr)
+		{
+			break;
+		}
+
+		//Taken out of the ring before dispatching, a delegate might close the connection and drain again.
+		const FBPDecodedMessage Decoded = MoveTemp(Record->Decoded);
+		const int32 Id = Record->Id;
+		const double ReceivedAt = Record->ReceivedAt;
+		const EBPInboundRejectReason Rejected = Record->Rejected;
+		const int32 PacketBytes = Record->PacketBytes;
+		InboundThread->Pop();
+
+		if (Rejected != EBPInboundRejectReason::None)
+		{
+			RejectPacket(Rejected, PacketBytes);
+			continue;
+		}
+		RecordReply(Decoded.Type, Id, ReceivedAt);
+		if (Decoded.Message.IsValid())
+		{
+			DispatchMessage(Decoded);
+		}
+	}
+}
+
+void UBPDeviceSubsystem::FlushInbound()
+{
+	if (!InboundThread.IsValid() || !InboundThread->IsRunning())
+	{
+		return;
+	}
+
+	//Drained as we wait, the thread may be held up on a full ring.
+	const double Deadline = FPlatformTime::Seconds() + 0.5;
+	do
+	{
+		DrainInbound(0);
+	}
+	while (!InboundThread->WaitUntilParsed(0.001) && FPlatformTime::Seconds() < Deadline);
+	DrainInbound(0);
+}
+
+void UBPDeviceSubsystem::OnMessage(TConstArrayView<uint8> Message)
+{
+	DecodedMessages.Reset();
+	int32 Skipped = 0;
+	const EBPInboundRejectReason Rejected = UBPTypes::DeserializeMessage(this, Message, DecodedMessages,
+		[this](EBPMessageType Type, int32 Id)
+		{
+			//Timed here, before filtering, as most Ok replies are never decoded.
+			RecordReply(Type, Id, FPlatformTime::Seconds());
+			return WantsMessage(Type, Id);
+		}, Skipped);
+	SkippedMessageCount += Skipped;
+	if (Rejected != EBPInboundRejectReason::None)
+	{
+		//Anything decoded before the problem was complete and valid, so it still goes out below.
+		RejectPacket(Rejected, Message.Num());
+	}
+
+	for (const FBPDecodedMessage& Decoded : DecodedMessages)
+	{
+		DispatchMessage(Decoded);
+	}
+}
+
+void UBPDeviceSubsystem::DispatchMessage(const FBPDecodedMessage& Decoded)
+{
+	const FInstancedStruct& Msg = Decoded.Message;
+
+	UpdateKnownDevices(Decoded);
+	NotifyListeners(Decoded.Type, Msg);
+
+	FBPResponseHandler Response;
+	if (ResponseDelegates.Remove(Msg.Get<FBPMessageBase>().GetId(), Response))
+	{
+		Response.Execute(Msg);
+	}
+}
+
+void UBPDeviceSubsystem::NotifyListeners(EBPMessageType Type, const FInstancedStruct& Message)
+{
+	const uint8 TypeIndex = (uint8)Type;
+	NativeMessageDelegates[TypeIndex].Broadcast(Message);
+	const FDispatchTable& DispatchTable = GetDispatchTable();
+	if (DispatchTable[TypeIndex].Broadcast)
+	{
+		(this->*DispatchTable[TypeIndex].Broadcast)(Message);
+	}
+}
+
+bool UBPDeviceSubsystem::WantsMessage(EBPMessageType Type, int32 Id) const
+{
+	return WantsType(Type) || ResponseDelegates.Contains(Id);
+}
+
+bool UBPDeviceSubsystem::WantsType(EBPMessageType Type) const
+{
+	const uint8 TypeIndex = (uint8)Type;
+	const FDispatchEntry& Entry = GetDispatchTable()[TypeIndex];
+	const bool bTracksDevices = Type == EBPMessageType::DeviceList || Type == EBPMessageType::DeviceAdded || Type == EBPMessageType::DeviceRemoved;
+	return bTracksDevices
+		|| NativeMessageDelegates[TypeIndex].IsBound()
+		|| (Entry.IsBound && (this->*Entry.IsBound)());
+}
+
+uint32 UBPDeviceSubsystem::GetWantedTypes() const
+{
+	static_assert((uint8)EBPMessageType::MAX <= 32, "Wanted types no longer fit in a uint32.");
+	uint32 Wanted = 0;
+	for (uint8 TypeIndex = 0; TypeIndex < (uint8)EBPMessageType::MAX; TypeIndex++)
+	{
+		if (WantsType((EBPMessageType)TypeIndex))
+		{
+			Wanted |= 1u << TypeIndex;
+		}
+	}
+	return Wanted;
+}
+
+void UBPDeviceSubsystem::UpdateKnownDevices(const FBPDecodedMessage& Message)
+{
+	switch (Message.Type)
+	{
+	case EBPMessageType::DeviceList:
+		KnownDevices.Reset();
+		for (const FBPDeviceObject& Device : Message.Message.Get<FBPDeviceList>().Devices)
+		{
+			KnownDevices.Add(Device.DeviceIndex, Device);
+		}
+		break;
+	case EBPMessageType::DeviceAdded:
+	{
+		const FBPDeviceObject& Device = Message.Message.Get<FBPDeviceAdded>().Device;
+		KnownDevices.Add(Device.DeviceIndex, Device);
+		InvalidateDeviceQueries();
+		break;
+	}
+	case EBPMessageType::DeviceRemoved:
+		KnownDevices.Remove(Message.Message.Get<FBPDeviceRemove>().DeviceIndex);
+		ForgetDevice(Message.Message.Get<FBPDeviceRemove>().DeviceIndex);
+		DeviceFlows.Remove(Message.Message.Get<FBPDeviceRemove>().DeviceIndex);
+		InvalidateDeviceQueries();
+		break;
+	default:
+		return;
+	}
+	OutboundThread->SetDevices(KnownDevices);
+}
+
+int32 UBPDeviceSubsystem::GetStepCount(int32 DeviceIndex, TArray<FBPCommandMessage> FBPDeviceMessages::*Actuators, int32 ActuatorIndex) const
+{
+	const FBPDeviceObject* Device = KnownDevices.Find(DeviceIndex);
+	if (Device == nullptr)
+	{
+		return -1;
+	}
+	const TArray<FBPCommandMessage>& List = Device->DeviceMessages.*Actuators;
+	return List.IsValidIndex(ActuatorIndex) ? List[ActuatorIndex].StepCount : -1;
+}
+
+double UBPDeviceSubsystem::QuantizeActuatorValue(int32 DeviceIndex, TArray<FBPCommandMessage> FBPDeviceMessages::*Actuators, int32 ActuatorIndex, double Value) const
+{
+	return UBPTypes::QuantizeActuatorValue(Value, GetStepCount(DeviceIndex, Actuators, ActuatorIndex));
+}
+
+template<typename T, auto Event>
+void UBPDeviceSubsystem::BroadcastMessage(const FInstancedStruct& Message)
+{
+	auto& Delegate = this->*Event;
+	if (Delegate.IsBound())
+	{
+		Delegate.Broadcast(Message.Get<T>());
+	}
+}
+
+template<auto Event>
+bool UBPDeviceSubsystem::IsEventBound() const
+{
+	return (this->*Event).IsBound();
+}
+
+template<typename T, auto Event>
+UBPDeviceSubsystem::FDispatchEntry UBPDeviceSubsystem::MakeDispatchEntry()
+{
+	FDispatchEntry Entry;
+	Entry.Broadcast = &UBPDeviceSubsystem::BroadcastMessage<T, Event>;
+	Entry.IsBound = &UBPDeviceSubsystem::IsEventBound<Event>;
+	return Entry;
+}
+
+const UBPDeviceSubsystem::FDispatchTable& UBPDeviceSubsystem::GetDispatchTable()
+{
+	//One entry per message type, indexed by EBPMessageType, so dispatch is a single lookup.
+	static const FDispatchTable DispatchTable = []()
+	{
+		FDispatchTable Table(InPlace, FDispatchEntry());
+		Table[(uint8)EBPMessageType::Ok] = MakeDispatchEntry<FBPMessageStatusOk, &UBPDeviceSubsystem::OnMessageStatusOkReceived>();
+		Table[(uint8)EBPMessageType::Error] = MakeDispatchEntry<FBPMessageStatusError, &UBPDeviceSubsystem::OnMessageStatusErrorReceived>();
+		Table[(uint8)EBPMessageType::Ping] = MakeDispatchEntry<FBPMessageStatusPing, &UBPDeviceSubsystem::OnMessageStatusPingReceived>();
+		Table[(uint8)EBPMessageType::RequestServerInfo] = MakeDispatchEntry<FBPMessageRequestServerInfo, &UBPDeviceSubsystem::OnMessageRequestServerInfoReceived>();
+		Table[(uint8)EBPMessageType::ServerInfo] = MakeDispatchEntry<FBPMessageServerInfo, &UBPDeviceSubsystem::OnMessageServerInfoReceived>();
+		Table[(uint8)EBPMessageType::StartScanning] = MakeDispatchEntry<FBPStartScanning, &UBPDeviceSubsystem::OnStartScanningReceived>();
+		Table[(uint8)EBPMessageType::StopScanning] = MakeDispatchEntry<FBPStopScanning, &UBPDeviceSubsystem::OnStopScanningReceived>();
+		Table[(uint8)EBPMessageType::ScanningFinished] = MakeDispatchEntry<FBPScanningFinished, &UBPDeviceSubsystem::OnScanningFinishedReceived>();
+		Table[(uint8)EBPMessageType::RequestDeviceList] = MakeDispatchEntry<FBPRequestDeviceList, &UBPDeviceSubsystem::OnRequestDeviceListReceived>();
+		Table[(uint8)EBPMessageType::DeviceList] = MakeDispatchEntry<FBPDeviceList, &UBPDeviceSubsystem::OnDeviceListReceived>();
+		Table[(uint8)EBPMessageType::DeviceAdded] = MakeDispatchEntry<FBPDeviceAdded, &UBPDeviceSubsystem::OnDeviceAddedReceived>();
+		Table[(uint8)EBPMessageType::DeviceRemoved] = MakeDispatchEntry<FBPDeviceRemove, &UBPDeviceSubsystem::OnDeviceRemoveReceived>();
+		Table[(uint8)EBPMessageType::StopDeviceCmd] = MakeDispatchEntry<FBPStopDeviceCmd, &UBPDeviceSubsystem::OnStopDeviceCmdReceived>();
+		Table[(uint8)EBPMessageType::StopAllDevices] = MakeDispatchEntry<FBPStopAllDevices, &UBPDeviceSubsystem::OnStopAllDevicesReceived>();
+		Table[(uint8)EBPMessageType::ScalarCmd] = MakeDispatchEntry<FBPScalarCommand, &UBPDeviceSubsystem::OnScalarCommandReceived>();
+		Table[(uint8)EBPMessageType::LinearCmd] = MakeDispatchEntry<FBPLinearCommand, &UBPDeviceSubsystem::OnLinearCommandReceived>();
+		Table[(uint8)EBPMessageType::RotateCmd] = MakeDispatchEntry<FBPRotateCommand, &UBPDeviceSubsystem::OnRotateCommandReceived>();
+		Table[(uint8)EBPMessageType::SensorMessageBase] = MakeDispatchEntry<FBPSensorMessageBase, &UBPDeviceSubsystem::OnSensorMessageBaseReceived>();
+		Table[(uint8)EBPMessageType::SensorReadCmd] = MakeDispatchEntry<FBPSensorReadCommand, &UBPDeviceSubsystem::OnSensorReadCommandReceived>();
+		Table[(uint8)EBPMessageType::SensorReading] = MakeDispatchEntry<FBPSensorReading, &UBPDeviceSubsystem::OnSensorReadingReceived>();
+		Table[(uint8)EBPMessageType::SensorSubscribeCmd] = MakeDispatchEntry<FBPSensorSubscribeCommand, &UBPDeviceSubsystem::OnSensorSubscribeCommandReceived>();
+		Table[(uint8)EBPMessageType::SensorUnsubscribeCmd] = MakeDispatchEntry<FBPSensorUnsubscribeCommand, &UBPDeviceSubsystem::OnSensorUnsubscribeCommandReceived>();
+		return Table;
+	}();
+	return DispatchTable;
+}
+
+void UBPDeviceSubsystem::OnRawMessage(const void* Data, SIZE_T Size, SIZE_T BytesRemaining)
+{
+	//Common case, the whole frame arrived in one go, so parse it straight out of the socket's memory.
+	if (BytesRemaining == 0 && ReceiveBuffer.Num() == 0 && !bDiscardingFrame)
+	{
+		OnFrameReceived(TConstArrayView<uint8>((const uint8*)Data, (int32)Size));
+		return;
+	}
+
+	//Never buffer more than we would be willing to parse.
+	const int64 FrameBytes = (int64)ReceiveBuffer.Num() + DiscardedFrameBytes + Size + BytesRemaining;
+	if (!bDiscardingFrame && FrameBytes > UButtplugUESettings::GetMaxInboundPacketBytes())
+	{
+		bDiscardingFrame = true;
+		DiscardedFrameBytes = ReceiveBuffer.Num();
+		ReceiveBuffer.Empty();
+	}
+
+	if (bDiscardingFrame)
+	{
+		DiscardedFrameBytes += (int32)FMath::Min<SIZE_T>(Size, MAX_int32 - DiscardedFrameBytes);
+		if (BytesRemaining == 0)
+		{
+			RejectPacket(EBPInboundRejectReason::TooLarge, DiscardedFrameBytes);
+			bDiscardingFrame = false;
+			DiscardedFrameBytes = 0;
+		}
+		return;
+	}
+
+	//Otherwise stitch the fragments together, keeping the buffer's allocation around for next time.
+	ReceiveBuffer.Append((const uint8*)Data, (int32)Size);
+	if (BytesRemaining == 0)
+	{
+		OnFrameReceived(ReceiveBuffer);
+		ReceiveBuffer.Reset();
+	}
+}
+
+void UBPDeviceSubsystem::RejectPacket(EBPInboundRejectReason Reason, int32 PacketBytes)
+{
+	RejectedPacketCount++;
+	INC_DWORD_STAT(STAT_BPRejectedPackets);
+	OnInboundPacketRejected.Broadcast(Reason, PacketBytes);
+}
+
+void UBPDeviceSubsystem::OnMessageSent(const FString& MessageString)
+{
+	BPLog::Message(this, "Message Sent: " + MessageString);
+}
+
+namespace
+{
+	bool IsActuatorCommand(EBPMessageType Type)
+	{
+		return Type == EBPMessageType::ScalarCmd || Type == EBPMessageType::LinearCmd || Type == EBPMessageType::RotateCmd;
+	}
+}
+
+void UBPDeviceSubsystem::RecordSent(int32 Id, EBPMessageType Type, int32 DeviceIndex)
+{
+	const double Now = FPlatformTime::Seconds();
+	FSentTable::FEntry Evicted;
+	//Only once there are as many requests unanswered as the table holds, the oldest is not going to be.
+	if (SentLog.Add(Id, { Type, DeviceIndex, Now }, Now + UButtplugUESettings::GetResponseTimeoutSeconds(), Evicted))
+	{
+		WriteOffSent(Evicted.Payload);
+	}
+	if (IsActuatorCommand(Type))
+	{
+		OnDeviceCommandSent(DeviceIndex);
+	}
+}
+
+void UBPDeviceSubsystem::WriteOffSent(const FSentRecord& Sent)
+{
+	if (IsActuatorCommand(Sent.Type))
+	{
+		OnDeviceCommandAnswered(Sent.DeviceIndex, false, 0.0);
+	}
+}
+
+void UBPDeviceSubsystem::RecordReply(EBPMessageType Type, int32 Id, double ReceivedAt)
+{
+	if (Type == EBPMessageType::Ok || Type == EBPMessageType::Error)
+	{
+		Shadow.OnReply(Id, Type == EBPMessageType::Ok);
+	}
+
+	//Server initiated messages have Id 0, and a request already written off can no longer be matched.
+	FSentRecord Sent;
+	if (Id <= 0 || !SentLog.Remove(Id, Sent))
+	{
+		return;
+	}
+
+	const double Latency = ReceivedAt - Sent.SentAt;
+	TypeLatency[(uint8)Sent.Type].Record(Latency);
+	if (Sent.DeviceIndex != INDEX_NONE)
+	{
+		DeviceLatency.FindOrAdd(Sent.DeviceIndex).Record(Latency);
+	}
+	if (IsActuatorCommand(Sent.Type))
+	{
+		OnDeviceCommandAnswered(Sent.DeviceIndex, Type == EBPMessageType::Ok, Latency);
+	}
+}
+
+FBPLatencySummary UBPDeviceSubsystem::GetMessageLatency(EBPMessageType Type) const
+{
+	if (Type == EBPMessageType::MAX)
+	{
+		return FBPLatencySummary();
+	}
+	return TypeLatency[(uint8)Type].Summarize();
+}
+
+FBPLatencySummary UBPDeviceSubsystem::GetDeviceLatency(int32 DeviceIndex) const
+{
+	const FBPLatencyHistogram* Histogram = DeviceLatency.Find(DeviceIndex);
+	return Histogram ? Histogram->Summarize() : FBPLatencySummary();
+}
+
+void UBPDeviceSubsystem::ResetLatencyStats()
+{
+	for (FBPLatencyHistogram& Histogram : TypeLatency)
+	{
+		Histogram.Reset();
+	}
+	DeviceLatency.Reset();
+}
+
+void UBPDeviceSubsystem::ExpireResponses()
+{
+	//Commands a stop took back off the outbound thread should fail now, not when they time out.
+	CollectDroppedCommands();
+
+	const double Now = FPlatformTime::Seconds();
+	FResponseTable::FEntry Expired;
+	while (ResponseDelegates.PopExpired(Now, Expired))
+	{
+		FailResponse(Expired, "Timed out waiting for a response.");
+	}
+	FSentTable::FEntry Unanswered;
+	while (SentLog.PopExpired(Now, Unanswered))
+	{
+		WriteOffSent(Unanswered.Payload);
+	}
+}
+
+void UBPDeviceSubsystem::FailResponse(FResponseTable::FEntry& Entry, const FString& Reason)
+{
+	FStringFormatNamedArguments Args;
+	Args.Add("Id", Entry.Id);
+	Args.Add("Reason", Reason);
+	BPLog::Warning(this, "Request {Id}: {Reason}", Args, false);
+
+	Entry.Payload.Execute(FInstancedStruct::Make<FBPMessageStatusError>(Entry.Id, Reason, EBPErrorCode::ERROR_UNKNOWN));
+}
+
+int32 UBPDeviceSubsystem::MakeMessageId()
+{
+	return OutboundThread->AllocateMessageId();
+}
+
+void UBPDeviceSubsystem::OnServerHandshake(const FBPMessageServerInfo& ServerInfo)
+{
+	if (ServerInfo.MaxPingTime > 0)
+	{
+		BPLog::Message(this, "Received Max Ping Time, beginning ping loop.");
+		ServerPingTimer.Invalidate();
+		FTimerDelegate PingDelegate = FTimerDelegate::CreateUObject(this, &UBPDeviceSubsystem::PingServer, FBPInstancedResponseDelegate());
+		GetWorld()->GetTimerManager().SetTimer(ServerPingTimer, PingDelegate, (ServerInfo.MaxPingTime * 1000.0f) * 0.9f, true);
+		PingServer(FBPInstancedResponseDelegate());
+	}
+	OnMessageServerInfoReceived.Remove(this, FName("OnServerHandshake"));
+}
+
+template<typename T, typename ...TArgs>
+int32 UBPDeviceSubsystem::PackAndSendMessage(FBPResponseHandler Response, TArgs && ...InArgs)
+{
+	T Request(-1, Forward<TArgs>(InArgs)...);
+	return SendMessage(MoveTemp(Response), Request);
+}
+
+template<typename T>
+int32 UBPDeviceSubsystem::SendMessage(FBPResponseHandler Response, T& Message)
+{
+	const int32 MessageId = MakeMessageId();
+	Message.Id = MessageId;
+	const int32 DeviceIndex = FBPMessageRegistry::GetDeviceIndex(Message);
+	RecordSent(MessageId, FBPMessageRegistry::GetInfo<T>().Type, DeviceIndex);
+	TrackResponse(MessageId, MoveTemp(Response));
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_BPSerializeOutbound);
+		Outbound.Add(FBPMessageRegistry::GetInfo<T>(), &Message, MessageId, DeviceIndex);
+	}
+	INC_DWORD_STAT(STAT_BPOutboundMessages);
+	OnMessageQueued();
+	return MessageId;
+}
+
+void UBPDeviceSubsystem::TrackResponse(int32 MessageId, FBPResponseHandler&& Response)
+{
+	//Nothing to call back for an unbound delegate, so there is no point tracking it.
+	if (Response.IsBound())
+	{
+		FResponseTable::FEntry Evicted;
+		const double Deadline = FPlatformTime::Seconds() + UButtplugUESettings::GetResponseTimeoutSeconds();
+		if (ResponseDelegates.Add(MessageId, MoveTemp(Response), Deadline, Evicted))
+		{
+			FailResponse(Evicted, "Too many requests waiting on a response, this one was dropped.");
+		}
+		InboundThread->AwaitResponse(MessageId, [this](int32 Id) { return ResponseDelegates.Contains(Id); });
+	}
+}
+
+template<typename T, typename ...TArgs>
+int32 UBPDeviceSubsystem::SendStop(FBPResponseHandler Response, int32 DeviceIndex, TArgs && ...InArgs)
+{
+	//Anything still pending would start the device again straight after the stop.
+	if (DeviceIndex == INDEX_NONE)
+	{
+		ForgetAllDevices();
+	}
+	else
+	{
+		ForgetDevice(DeviceIndex);
+	}
+	DropPendingCommands(DeviceIndex);
+	OutboundThread->ClearSubmitted(DeviceIndex);
+
+	T Request(-1, Forward<TArgs>(InArgs)...);
+	const int32 MessageId = MakeMessageId();
+	Request.Id = MessageId;
+	RecordSent(MessageId, FBPMessageRegistry::GetInfo<T>().Type, DeviceIndex);
+	TrackResponse(MessageId, MoveTemp(Response));
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_BPSerializeOutbound);
+		PriorityOutbound.Add(FBPMessageRegistry::GetInfo<T>(), &Request, MessageId, DeviceIndex);
+	}
+	INC_DWORD_STAT(STAT_BPOutboundMessages);
+	//Whatever else is batched for this frame follows in the next flush, behind the stop.
+	//Packets already handed to the outbound thread are overtaken, and it takes this device's commands back out of them.
+	FBPOutboundPacket Packet;
+	if (TakePacket(PriorityOutbound, Packet))
+	{
+		OutboundThread->SendStop(MoveTemp(Packet), DeviceIndex);
+	}
+	return MessageId;
+}
+
+void UBPDeviceSubsystem::DropPendingCommands(int32 DeviceIndex)
+{
+	TArray<int32> Dropped;
+	Outbound.RemoveDeviceCommands(DeviceIndex, Dropped);
+	for (int32 Id : Dropped)
+	{
+		ForgetDroppedCommand(Id);
+	}
+}
+
+void UBPDeviceSubsystem::CollectDroppedCommands()
+{
+	if (!OutboundThread.IsValid())
+	{
+		return;
+	}
+	int32 Id;
+	while (OutboundThread->TakeDroppedId(Id))
+	{
+		ForgetDroppedCommand(Id);
+	}
+}
+
+void UBPDeviceSubsystem::CollectSubmittedSends()
+{
+	if (!OutboundThread.IsValid())
+	{
+		return;
+	}
+	FBPSubmittedSend Sent;
+	while (OutboundThread->TakeSubmittedSend(Sent))
+	{
+		Shadow.RemoveActuator(Sent.DeviceIndex, Sent.Type, Sent.ActuatorIndex);
+		FDeviceFlow& Flow = DeviceFlows.FindOrAdd(Sent.DeviceIndex);
+		Flow.ReadyTime = FMath::Max(Flow.ReadyTime, Sent.ReadyTime);
+	}
+}
+
+void UBPDeviceSubsystem::ForgetDroppedCommand(int32 Id)
+{
+	FResponseTable::FEntry Entry;
+	Entry.Id = Id;
+	if (ResponseDelegates.Remove(Id, Entry.Payload))
+	{
+		FailResponse(Entry, "Dropped by a stop before it was sent.");
+	}
+
+	//It will never be answered, so it no longer counts against the device.
+	FSentRecord Sent;
+	if (SentLog.Remove(Id, Sent))
+	{
+		WriteOffSent(Sent);
+	}
+}
+
+template<typename T>
+int32 UBPDeviceSubsystem::SendCommand(FBPResponseHandler Response, T& Command)
+{
+	CollectSubmittedSends();
+	if (Response.IsBound())
+	{
+		//Replies are matched by Id, so this goes out on its own and is never dropped.
+		//Older pending values for the same actuators must not land after it.
+		Coalescer.Remove(Command);
+		const int32 MessageId = SendMessage(MoveTemp(Response), Command);
+		Shadow.RecordSent(Command, MessageId);
+		DelayDevice(Command.DeviceIndex, FPlatformTime::Seconds());
+		return MessageId;
+	}
+
+	//Commands for a device still inside its timing gap are always held, the coalescer is where they wait.
+	//Otherwise only batched flushes coalesce, and only if asked to.
+	const double Now = FPlatformTime::Seconds();
+	const bool bReady = IsDeviceReady(Command.DeviceIndex, Now);
+	if (!bReady || bCoalesceCommands)
+	{
+		bool bMerged = false;
+		const int32 MessageId = Coalescer.Add(Command, [this]() { return MakeMessageId(); }, bMerged);
+		if (bMerged)
+		{
+			INC_DWORD_STAT(STAT_BPCoalescedCommands);
+		}
+		if (!bReady)
+		{
+			INC_DWORD_STAT(STAT_BPRateLimitedCommands);
+		}
+		return MessageId;
+	}
+
+	Command.Id = MakeMessageId();
+	WriteCommand(Command);
+	if (Command.Id != 0)
+	{
+		DelayDevice(Command.DeviceIndex, Now);
+	}
+	OnMessageQueued();
+	return Command.Id;
+}
+
+template<typename T>
+void UBPDeviceSubsystem::WriteCommand(T& Command)
+{
+	if (bSuppressRedundant && !Shadow.RemoveRedundant(Command))
+	{
+		INC_DWORD_STAT(STAT_BPSuppressedCommands);
+		Command.Id = 0;
+		return;
+	}
+
+	const FBPMessageTypeInfo& Info = FBPMessageRegistry::GetInfo<T>();
+	{
+		SCOPE_CYCLE_COUNTER(STAT_BPSerializeOutbound);
+		Outbound.Add(Info, &Command, Command.Id, Command.DeviceIndex);
+	}
+	INC_DWORD_STAT(STAT_BPOutboundMessages);
+	RecordSent(Command.Id, Info.Type, Command.DeviceIndex);
+	Shadow.RecordSent(Command, Command.Id);
+}
+
+void UBPDeviceSubsystem::ForgetDevice(int32 DeviceIndex)
+{
+	Coalescer.RemoveDevice(DeviceIndex);
+	Shadow.RemoveDevice(DeviceIndex);
+	//Commands already sent are still owed a reply, so only the pacing is cleared.
+	if (FDeviceFlow* Flow = DeviceFlows.Find(DeviceIndex))
+	{
+		Flow->ReadyTime = 0.0;
+	}
+}
 
-	FStringFormatNamedArguments Args;
-	Args.Add("Server", UButtplugUESettings::GetButtplugServer());
-	Args.Add("Port", UButtplugUESettings::GetButtplugPort());
-	FString Server = FString::Format(TEXT("{Server}:{Port}"), Args);
+void UBPDeviceSubsystem::ForgetAllDevices()
+{
+	Coalescer.Reset();
+	Shadow.Reset();
+	for (TPair<int32, FDeviceFlow>& Flow : DeviceFlows)
+	{
+		Flow.Value.ReadyTime = 0.0;
+	}
+}
 
-	Socket = FWebSocketsModule::Get().CreateWebSocket(Server, "ws");
+namespace
+{
+	//Bounds on the extra spacing a slow device gets, doubled each time it backs up and eased off as it answers promptly.
+	constexpr double MinBackoffSeconds = 0.05;
+	constexpr double MaxBackoffSeconds = 1.0;
+	constexpr double BackoffRecovery = 0.75;
+}
 
-	if (Socket.IsValid())
+bool UBPDeviceSubsystem::IsDeviceReady(int32 DeviceIndex, double Now) const
+{
+	const FDeviceFlow* Flow = bRateLimit ? DeviceFlows.Find(DeviceIndex) : nullptr;
+	if (Flow == nullptr)
 	{
-		Socket->OnConnected().AddUObject(this, &UBPDeviceSubsystem::OnConnected);
-		Socket->OnConnectionError().AddUObject(this, &UBPDeviceSubsystem::OnConnectionError);
-		Socket->OnClosed().AddUObject(this, &UBPDeviceSubsystem::OnClosed);
-		Socket->OnMessage().AddUObject(this, &UBPDeviceSubsystem::OnMessage);
-		Socket->OnRawMessage().AddUObject(this, &UBPDeviceSubsystem::OnRawMessage);
-		Socket->OnMessageSent().AddUObject(this, &UBPDeviceSubsystem::OnMessageSent);
+		return true;
+	}
+	//Held until replies catch up. Commands that are never answered stop counting once they time out, see ExpireResponses.
+	if (MaxUnacked > 0 && Flow->Unacked >= MaxUnacked)
+	{
+		return false;
+	}
+	return Flow->ReadyTime <= Now;
+}
 
-		if(UButtplugUESettings::GetAutoConnect())
+void UBPDeviceSubsystem::DelayDevice(int32 DeviceIndex, double Now)
+{
+	//A bucket holding a single token: sending takes it, and it comes back one interval later. Never more than one command per gap.
+	const double Interval = GetDeviceCommandInterval(DeviceIndex);
+	if (Interval > 0.0)
+	{
+		DeviceFlows.FindOrAdd(DeviceIndex).ReadyTime = Now + Interval;
+		//Values from FBPCommandSubmitter are paced on the outbound thread, and have to wait for this command's gap too.
+		if (OutboundThread.IsValid())
 		{
-			BPLog::Message(this, "Attempting to Connect to Buttplug Server at: " + Server);
-			Socket->Connect();
+			OutboundThread->DelaySubmitted(DeviceIndex, Now + Interval);
 		}
 	}
-	else
+}
+
+void UBPDeviceSubsystem::OnDeviceCommandSent(int32 DeviceIndex)
+{
+	if (!bRateLimit || MaxUnacked <= 0 || DeviceIndex == INDEX_NONE)
 	{
-		BPLog::Error(this, "Failed to Create Socket for Buttplug Server at: {Server}!", Args);
+		return;
+	}
+
+	//Every command counted here is taken back off by its reply, its timeout, or a stop dropping it, never reset wholesale.
+	//Not every send waits for the device to be ready, so this can go past the limit, but only reaching it backs the device off.
+	FDeviceFlow& Flow = DeviceFlows.FindOrAdd(DeviceIndex);
+	if (++Flow.Unacked == MaxUnacked)
+	{
+		Flow.Backoff = FMath::Clamp(Flow.Backoff * 2.0, MinBackoffSeconds, MaxBackoffSeconds);
 	}
 }
 
-void UBPDeviceSubsystem::Deinitialize()
+void UBPDeviceSubsystem::OnDeviceCommandAnswered(int32 DeviceIndex, bool bSucceeded, double Latency)
 {
-	if (IsConnected())
+	FDeviceFlow* Flow = DeviceFlows.Find(DeviceIndex);
+	if (Flow == nullptr)
 	{
-		Disconnect();
+		return;
 	}
 
-	Super::Deinitialize();
+	Flow->Unacked = FMath::Max(Flow->Unacked - 1, 0);
+	if (bSucceeded && Latency <= LatencyTarget && Flow->Backoff > 0.0)
+	{
+		Flow->Backoff *= BackoffRecovery;
+		if (Flow->Backoff < MinBackoffSeconds)
+		{
+			Flow->Backoff = 0.0;
+		}
+	}
 }
 
-bool UBPDeviceSubsystem::IsConnected() const
+float UBPDeviceSubsystem::GetDeviceCommandInterval(int32 DeviceIndex) const
 {
-	return Socket.IsValid() && Socket->IsConnected();
+	if (!bRateLimit)
+	{
+		return 0.0f;
+	}
+
+	//Devices that do not report a gap (-1) are only limited while backing off.
+	const FBPDeviceObject* Device = KnownDevices.Find(DeviceIndex);
+	const double Gap = Device != nullptr ? FMath::Max(Device->DeviceMessageTimingGap, 0) / 1000.0 : 0.0;
+	const FDeviceFlow* Flow = DeviceFlows.Find(DeviceIndex);
+	return (float)FMath::Max(Gap, Flow != nullptr ? Flow->Backoff : 0.0);
 }
 
-void UBPDeviceSubsystem::OnConnected()
+int32 UBPDeviceSubsystem::GetUnackedCommandCount(int32 DeviceIndex) const
 {
-	FStringFormatNamedArguments Args;
-	Args.Add("Server", UButtplugUESettings::GetButtplugServer());
-	Args.Add("Port", UButtplugUESettings::GetButtplugPort());
-	BPLog::Message(this, "Successfully Connected to Buttplug Server at: {Server}:{Port}. Requesting Server Info Handshake.", Args);
-
-	//TODO Calling this here for now since it needs to be done to establish a viable connection.
-	OnMessageServerInfoReceived.AddDynamic(this, &UBPDeviceSubsystem::OnServerHandshake);
-	RequestServerInfo(FBPInstancedResponseDelegate());
+	const FDeviceFlow* Flow = DeviceFlows.Find(DeviceIndex);
+	return Flow != nullptr ? Flow->Unacked : 0;
 }
 
-void UBPDeviceSubsystem::OnConnectionError(const FString& Error)
+void UBPDeviceSubsystem::OnMessageQueued()
 {
-	FStringFormatNamedArguments Args;
-	Args.Add("Server", UButtplugUESettings::GetButtplugServer());
-	Args.Add("Port", UButtplugUESettings::GetButtplugPort());
-	Args.Add("Error", Error);
-	BPLog::Error(this, "Failed to Connect to Buttplug Server at: {Server}:{Port}! Check that the Intiface Central is running and you have the right server address/port. Error Message: {Error}", Args);
+	if (FlushMode == EBPOutboundFlushMode::Immediate || Outbound.GetPendingBytes() >= UButtplugUESettings::GetMaxOutboundPacketBytes())
+	{
+		FlushOutbound();
+	}
 }
 
-void UBPDeviceSubsystem::OnClosed(int32 StatusCode, const FString& Reason, bool bWasClean)
+void UBPDeviceSubsystem::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
 {
-	ServerPingTimer.Invalidate();
-	FStringFormatNamedArguments Args;
-	Args.Add("StatusCode", StatusCode);
-	Args.Add("Reason", Reason);
-	Args.Add("WasClean", bWasClean);
-	BPLog::Message(this, "Connection to Buttplug Server Closed! Code: {StatusCode}, Reason: {Reason}, WasClean: {WasClean}", Args);
-	OnServerDisconnect.Broadcast();
+	if (World == GetWorld())
+	{
+		FlushOutbound();
+	}
 }
 
-void UBPDeviceSubsystem::OnMessage(const FString& Message)
-{
-	BPLog::Message(this, "Message Received: " + Message);
-	TArray<FInstancedStruct> Messages = UBPTypes::DeserializeMessage(this, Message);
-
-	for (const FInstancedStruct& Msg : Messages)
-	{
-		//TODO see if there is a better way to do this without a manual IF statement
-		//Might end up being another map :(
-		if (Msg.GetScriptStruct() == FBPMessageStatusOk::StaticStruct()) { OnMessageStatusOkReceived.Broadcast(Msg.Get<FBPMessageStatusOk>()); }
-		else if (Msg.GetScriptStruct() == FBPMessageStatusError::StaticStruct()) { OnMessageStatusErrorReceived.Broadcast(Msg.Get<FBPMessageStatusError>()); }
-		else if (Msg.GetScriptStruct() == FBPMessageStatusPing::StaticStruct()) { OnMessageStatusPingReceived.Broadcast(Msg.Get<FBPMessageStatusPing>()); }
-		else if (Msg.GetScriptStruct() == FBPMessageRequestServerInfo::StaticStruct()) { OnMessageRequestServerInfoReceived.Broadcast(Msg.Get<FBPMessageRequestServerInfo>()); }
-		else if (Msg.GetScriptStruct() == FBPMessageServerInfo::StaticStruct()) { OnMessageServerInfoReceived.Broadcast(Msg.Get<FBPMessageServerInfo>()); }
-		else if (Msg.GetScriptStruct() == FBPStartScanning::StaticStruct()) { OnStartScanningReceived.Broadcast(Msg.Get<FBPStartScanning>()); }
-		else if (Msg.GetScriptStruct() == FBPStopScanning::StaticStruct()) { OnStopScanningReceived.Broadcast(Msg.Get<FBPStopScanning>()); }
-		else if (Msg.GetScriptStruct() == FBPScanningFinished::StaticStruct()) { OnScanningFinishedReceived.Broadcast(Msg.Get<FBPScanningFinished>()); }
-		else if (Msg.GetScriptStruct() == FBPRequestDeviceList::StaticStruct()) { OnRequestDeviceListReceived.Broadcast(Msg.Get<FBPRequestDeviceList>()); }
-		else if (Msg.GetScriptStruct() == FBPDeviceList::StaticStruct()) { OnDeviceListReceived.Broadcast(Msg.Get<FBPDeviceList>()); }
-		else if (Msg.GetScriptStruct() == FBPDeviceAdded::StaticStruct()) { OnDeviceAddedReceived.Broadcast(Msg.Get<FBPDeviceAdded>()); }
-		else if (Msg.GetScriptStruct() == FBPDeviceRemove::StaticStruct()) { OnDeviceRemoveReceived.Broadcast(Msg.Get<FBPDeviceRemove>()); }
-		else if (Msg.GetScriptStruct() == FBPStopDeviceCmd::StaticStruct()) { OnStopDeviceCmdReceived.Broadcast(Msg.Get<FBPStopDeviceCmd>()); }
-		else if (Msg.GetScriptStruct() == FBPStopAllDevices::StaticStruct()) { OnStopAllDevicesReceived.Broadcast(Msg.Get<FBPStopAllDevices>()); }
-		else if (Msg.GetScriptStruct() == FBPScalarCommand::StaticStruct()) { OnScalarCommandReceived.Broadcast(Msg.Get<FBPScalarCommand>()); }
-		else if (Msg.GetScriptStruct() == FBPLinearCommand::StaticStruct()) { OnLinearCommandReceived.Broadcast(Msg.Get<FBPLinearCommand>()); }
-		else if (Msg.GetScriptStruct() == FBPRotateCommand::StaticStruct()) { OnRotateCommandReceived.Broadcast(Msg.Get<FBPRotateCommand>()); }
-		else if (Msg.GetScriptStruct() == FBPSensorMessageBase::StaticStruct()) { OnSensorMessageBaseReceived.Broadcast(Msg.Get<FBPSensorMessageBase>()); }
-		else if (Msg.GetScriptStruct() == FBPSensorReadCommand::StaticStruct()) { OnSensorReadCommandReceived.Broadcast(Msg.Get<FBPSensorReadCommand>()); }
-		else if (Msg.GetScriptStruct() == FBPSensorReading::StaticStruct()) { OnSensorReadingReceived.Broadcast(Msg.Get<FBPSensorReading>()); }
-		else if (Msg.GetScriptStruct() == FBPSensorSubscribeCommand::StaticStruct()) { OnSensorSubscribeCommandReceived.Broadcast(Msg.Get<FBPSensorSubscribeCommand>()); }
-		else if (Msg.GetScriptStruct() == FBPSensorUnsubscribeCommand::StaticStruct()) { OnSensorUnsubscribeCommandReceived.Broadcast(Msg.Get<FBPSensorUnsubscribeCommand>()); }
-
-		if (ResponseDelegates.Contains(Msg.GetPtr<FBPMessageBase>()->GetId()))
+void UBPDeviceSubsystem::FlushOutbound()
+{
+	//Merged commands go last, after anything (like a stop) issued before their final value.
+	//Devices still inside their timing gap keep theirs pending for a later flush.
+	CollectSubmittedSends();
+	const double Now = FPlatformTime::Seconds();
+	TArray<int32, TInlineAllocator<8>> SentDevices;
+	Coalescer.DrainIf(
+		[this, Now](int32 DeviceIndex) { return IsDeviceReady(DeviceIndex, Now); },
+		[this, &SentDevices](auto& Command)
 		{
-			ResponseDelegates.Find(Msg.GetPtr<FBPMessageBase>()->GetId())->ExecuteIfBound(Msg);
-			ResponseDelegates.Remove(Msg.GetPtr<FBPMessageBase>()->GetId());
-		}
+			WriteCommand(Command);
+			if (Command.Id != 0)
+			{
+				SentDevices.AddUnique(Command.DeviceIndex);
+			}
+		});
+	//Only once every command type for a device has gone, so its Scalar and Rotate values can share a flush.
+	for (int32 DeviceIndex : SentDevices)
+	{
+		DelayDevice(DeviceIndex, Now);
 	}
+
+	SendPacket(Outbound);
 }
 
-void UBPDeviceSubsystem::OnRawMessage(const void* Data, SIZE_T Size, SIZE_T BytesRemaining)
+void UBPDeviceSubsystem::SendPacket(FBPOutboundQueue& Queue)
 {
+	FBPOutboundPacket Packet;
+	if (TakePacket(Queue, Packet))
+	{
+		OutboundThread->Send(MoveTemp(Packet));
+	}
 }
 
-void UBPDeviceSubsystem::OnMessageSent(const FString& MessageString)
+bool UBPDeviceSubsystem::TakePacket(FBPOutboundQueue& Queue, FBPOutboundPacket& OutPacket)
 {
-	BPLog::Message(this, "Message Sent: " + MessageString);
+	CollectDroppedCommands();
+	if (Queue.Num() == 0)
+	{
+		return false;
+	}
+	OutPacket = OutboundThread->TakeSparePacket();
+	Queue.Finish(OutPacket);
+	if (!IsConnected())
+	{
+		return false;
+	}
+	INC_DWORD_STAT(STAT_BPOutboundPackets);
+	INC_DWORD_STAT_BY(STAT_BPOutboundBytes, OutPacket.Bytes.Num());
+	return true;
 }
 
-int32 UBPDeviceSubsystem::MakeMessageId()
+template<typename T>
+TFuture<FInstancedStruct> UBPDeviceSubsystem::SendMessageAsync(T& Message)
+{
+	return SendAsync([this, &Message](FBPResponseHandler&& Response) { SendMessage(MoveTemp(Response), Message); });
+}
+
+TFuture<FInstancedStruct> UBPDeviceSubsystem::SendAsync(TFunctionRef<void(FBPResponseHandler&&)> Send)
 {
-	//As if anyone will ever reach this stage.
-	if (MessageIdCounter == INT32_MAX)
+	TPromise<FInstancedStruct> Promise;
+	TFuture<FInstancedStruct> Future = Promise.GetFuture();
+	if (!IsConnected())
 	{
-		MessageIdCounter = 1;
+		BPLog::Error(this, "Tried to send message while not connected!");
+		Promise.SetValue(FInstancedStruct::Make<FBPMessageStatusError>(-1, FString("Not connected to Intiface."), EBPErrorCode::ERROR_UNKNOWN));
+		return Future;
 	}
-	else
+
+	//The response table guarantees the handler runs exactly once: on the reply, on timeout, or when the connection closes.
+	Send(FBPResponseHandler([Promise = MoveTemp(Promise)](const FInstancedStruct& Response) mutable { Promise.SetValue(Response); }));
+	return Future;
+}
+
+template<typename T, typename ...TArgs>
+int32 UBPDeviceSubsystem::SendQuery(FBPResponseHandler Response, const FQueryKey& Key, TArgs && ...InArgs)
+{
+	FQueryState& Query = Queries.FindOrAdd(Key);
+	if (Query.CachedResponse.IsValid() && FPlatformTime::Seconds() < Query.CachedUntil)
+	{
+		INC_DWORD_STAT(STAT_BPQueryCacheHits);
+		//Copied, as the handler may well make another query and move the map around.
+		const FInstancedStruct Cached = Query.CachedResponse;
+		//Delivered as if it had just arrived, so the subsystem's delegates hear it too and not only the caller, whose handler may be unbound.
+		if (const FBPMessageTypeInfo* Info = FBPMessageRegistry::Get().FindByStruct(Cached.GetScriptStruct()))
+		{
+			NotifyListeners(Info->Type, Cached);
+		}
+		Response.Execute(Cached);
+		return Cached.Get<FBPMessageBase>().GetId();
+	}
+
+	Query.Waiters.Add(MoveTemp(Response));
+	if (Query.InFlightId != INDEX_NONE)
 	{
-		MessageIdCounter++;
+		INC_DWORD_STAT(STAT_BPQueryShared);
+		return Query.InFlightId;
 	}
 
-	return MessageIdCounter;
+	Query.bStale = false;
+	const int32 MessageId = PackAndSendMessage<T>(FBPResponseHandler([this, Key](const FInstancedStruct& Reply) { CompleteQuery(Key, Reply); }),
+		Forward<TArgs>(InArgs)...);
+	Queries.FindChecked(Key).InFlightId = MessageId;
+	return MessageId;
 }
 
-void UBPDeviceSubsystem::OnServerHandshake(const FBPMessageServerInfo& ServerInfo)
+void UBPDeviceSubsystem::CompleteQuery(const FQueryKey& Key, const FInstancedStruct& Response)
 {
-	if (ServerInfo.MaxPingTime > 0)
+	FQueryState* Query = Queries.Find(Key);
+	if (Query == nullptr)
 	{
-		BPLog::Message(this, "Received Max Ping Time, beginning ping loop.");
-		ServerPingTimer.Invalidate();
-		FTimerDelegate PingDelegate = FTimerDelegate::CreateUObject(this, &UBPDeviceSubsystem::PingServer, FBPInstancedResponseDelegate());
-		GetWorld()->GetTimerManager().SetTimer(ServerPingTimer, PingDelegate, (ServerInfo.MaxPingTime * 1000.0f) * 0.9f, true);
-		PingServer(FBPInstancedResponseDelegate());
+		return;
+	}
+
+	TArray<FBPResponseHandler> Waiters = MoveTemp(Query->Waiters);
+	Query->InFlightId = INDEX_NONE;
+
+	//Errors (timeouts included) are never cached, the next query should ask again.
+	const float CacheSeconds = UButtplugUESettings::GetQueryCacheSeconds(Key.Type);
+	if (CacheSeconds > 0.0f && !Query->bStale && Response.GetScriptStruct() != FBPMessageStatusError::StaticStruct())
+	{
+		Query->CachedResponse = Response;
+		Query->CachedUntil = FPlatformTime::Seconds() + CacheSeconds;
+	}
+
+	for (FBPResponseHandler& Waiter : Waiters)
+	{
+		Waiter.Execute(Response);
+	}
+}
+
+void UBPDeviceSubsystem::InvalidateDeviceQueries()
+{
+	for (TPair<FQueryKey, FQueryState>& Query : Queries)
+	{
+		if (Query.Key.Type != EBPMessageType::RequestServerInfo)
+		{
+			Query.Value.CachedResponse.Reset();
+			Query.Value.bStale = Query.Value.InFlightId != INDEX_NONE;
+		}
 	}
-	OnMessageServerInfoReceived.Remove(this, FName("OnServerHandshake"));
 }
 
 template<typename T, typename ...TArgs>
-int32 UBPDeviceSubsystem::PackAndSendMessage(TOptional<FBPInstancedResponseDelegate> ResponseDelegate, TArgs && ...InArgs)
+TFuture<FInstancedStruct> UBPDeviceSubsystem::PackAndSendMessageAsync(TArgs && ...InArgs)
+{
+	T Request(-1, Forward<TArgs>(InArgs)...);
+	return SendMessageAsync(Request);
+}
+
+template<typename T>
+T& UBPDeviceSubsystem::GetScratchMessage()
 {
-	int32 MessageId = MakeMessageId();
-	FInstancedStruct RequestInstance = FInstancedStruct::Make<T>(MessageId, Forward<TArgs>(InArgs)...);
-	T Request = RequestInstance.GetMutable<T>();
-	FBPMessagePacket Message = UBPTypes::PackageMessage<T>(this, Request);
-	if (ResponseDelegate.IsSet())
+	FInstancedStruct& Scratch = ScratchMessages[(uint8)FBPMessageRegistry::GetInfo<T>().Type];
+	if (!Scratch.IsValid())
 	{
-		ResponseDelegates.Add(MessageId, ResponseDelegate.GetValue());
+		Scratch.InitializeAs<T>();
 	}
-	Socket->Send(Message.ToString());
-	return MessageId;
+	return Scratch.GetMutable<T>();
 }
 
+int32 UBPDeviceSubsystem::SendPacketTemplate(FBPPacketTemplate& Template, const FInstancedStruct* Source /*= nullptr*/)
+{
+	if (!IsConnected())
+	{
+		BPLog::Error(this, "Tried to send message while not connected!");
+		return -1;
+	}
+
+	CollectSubmittedSends();
+	const double Now = FPlatformTime::Seconds();
+	const bool bReady = IsDeviceReady(Template.GetDeviceIndex(), Now);
+	//The template is only worth using if it goes out as it is. A ready device with nothing else pending gets it as the whole of
+	//this flush's command for it, later values wait for its gap. Otherwise it is merged with the rest and serialized at the flush.
+	const bool bMerge = !bReady || (bCoalesceCommands && Coalescer.IsPending(Template.GetDeviceIndex()));
+	if (Source != nullptr && bMerge)
+	{
+		bool bMerged = false;
+		const int32 MergedId = Coalescer.Add(*Source, [this]() { return MakeMessageId(); }, bMerged);
+		if (MergedId != -1)
+		{
+			if (bMerged)
+			{
+				INC_DWORD_STAT(STAT_BPCoalescedCommands);
+			}
+			if (!bReady)
+			{
+				INC_DWORD_STAT(STAT_BPRateLimitedCommands);
+			}
+			return MergedId;
+		}
+	}
+
+	if (bSuppressRedundant && Source != nullptr && Shadow.IsRedundant(*Source))
+	{
+		INC_DWORD_STAT(STAT_BPSuppressedCommands);
+		return 0;
+	}
+
+	const int32 MessageId = MakeMessageId();
+	Template.SetId(MessageId);
+	RecordSent(MessageId, Template.GetType(), Template.GetDeviceIndex());
+	if (Source != nullptr)
+	{
+		Shadow.RecordSent(*Source, MessageId);
+		DelayDevice(Template.GetDeviceIndex(), Now);
+	}
+
+	Outbound.AddPacket(Template.GetBytes(), Template.GetType(), MessageId, Template.GetDeviceIndex());
+	INC_DWORD_STAT(STAT_BPOutboundMessages);
+	OnMessageQueued();
+	return MessageId;
+}
 
 void UBPDeviceSubsystem::Connect()
 {
@@ -203,9 +1166,9 @@ void UBPDeviceSubsystem::Connect()
 		Socket->OnConnected().AddUObject(this, &UBPDeviceSubsystem::OnConnected);
 		Socket->OnConnectionError().AddUObject(this, &UBPDeviceSubsystem::OnConnectionError);
 		Socket->OnClosed().AddUObject(this, &UBPDeviceSubsystem::OnClosed);
-		Socket->OnMessage().AddUObject(this, &UBPDeviceSubsystem::OnMessage);
 		Socket->OnRawMessage().AddUObject(this, &UBPDeviceSubsystem::OnRawMessage);
 		Socket->OnMessageSent().AddUObject(this, &UBPDeviceSubsystem::OnMessageSent);
+		OutboundThread->SetSocket(Socket);
 
 		BPLog::Message(this, "Attempting to Connect to Buttplug Server at: " + Server);
 		Socket->Connect();
@@ -224,7 +1187,15 @@ void UBPDeviceSubsystem::Disconnect()
 		return;
 	}
 	StopAllDevices(FBPInstancedResponseDelegate());
+	FlushOutbound();
+	//Give the final stop a chance to actually leave before the socket goes.
+	if (!OutboundThread->WaitUntilSent(OutboundDrainSeconds))
+	{
+		BPLog::Warning(this, "Timed out waiting for outbound messages to send before disconnecting.");
+	}
 	BPLog::Message(this, "Disconnecting from Buttplug Server.");
+	//Waits out a send still in progress on the thread if the wait above timed out, so it cannot race the close.
+	OutboundThread->SetSocket(nullptr);
 	Socket->Close();
 	Socket.Reset();
 }
@@ -236,7 +1207,7 @@ int32 UBPDeviceSubsystem::RequestServerInfo(FBPInstancedResponseDelegate Respons
 		BPLog::Error(this, "Tried to send message while not connected!");
 		return -1;
 	}
-	return PackAndSendMessage<FBPMessageRequestServerInfo>(Response, UButtplugUESettings::GetButtplugClientName(), 3);
+	return SendQuery<FBPMessageRequestServerInfo>(Response, FQueryKey{ EBPMessageType::RequestServerInfo }, UButtplugUESettings::GetButtplugClientName(), 3);
 }
 
 void UBPDeviceSubsystem::PingServer(FBPInstancedResponseDelegate Response)
@@ -257,7 +1228,7 @@ int32 UBPDeviceSubsystem::RequestDeviceList(FBPInstancedResponseDelegate Respons
 		BPLog::Error(this, "Tried to send message while not connected!");
 		return -1;
 	}
-	return PackAndSendMessage<FBPRequestDeviceList>(Response);
+	return SendQuery<FBPRequestDeviceList>(Response, FQueryKey{ EBPMessageType::RequestDeviceList });
 }
 
 int32 UBPDeviceSubsystem::StopDevice(const FBPDeviceObject& Device, FBPInstancedResponseDelegate Response, bool bStopPatterns /*= false*/)
@@ -269,18 +1240,9 @@ int32 UBPDeviceSubsystem::StopDevice(const FBPDeviceObject& Device, FBPInstanced
 	}
 	if(bStopPatterns)
 	{
-		//for(const TPair<FGuid, UBPManagedCommand*> Command : ManagedCommands)
-		TArray<UBPManagedCommand*> Commands;
-		ManagedCommands.GenerateValueArray(Commands);
-		for(int i = 0; i < Commands.Num(); i++)
-		{
-			if(Commands[i]->GetDevice() == Device)
-			{
-				Commands[i]->StopCommand();
-			}
-		}
+		StopDevicePatterns(Device);
 	}
-	return PackAndSendMessage<FBPStopDeviceCmd>(Response, Device.DeviceIndex);
+	return SendStop<FBPStopDeviceCmd>(Response, Device.DeviceIndex, Device.DeviceIndex);
 }
 
 int32 UBPDeviceSubsystem::StopAllDevices(FBPInstancedResponseDelegate Response, bool bStopPatterns /*= true*/)
@@ -292,15 +1254,9 @@ int32 UBPDeviceSubsystem::StopAllDevices(FBPInstancedResponseDelegate Response,
 	}
 	if (bStopPatterns)
 	{
-		for (const TPair<FGuid, UBPManagedCommand*> Command : ManagedCommands)
-		{
-			//Do not broadcast on stop completion to avoid changing the array while we are iterating through it.
-			Command.Value->StopCommand(false);
-			Command.Value->MarkAsGarbage();
-		}
-		ManagedCommands.Empty();
+		StopAllPatterns();
 	}
-	return PackAndSendMessage<FBPStopAllDevices>(Response);
+	return SendStop<FBPStopAllDevices>(Response, INDEX_NONE);
 }
 
 int32 UBPDeviceSubsystem::StartScanning(FBPInstancedResponseDelegate Response)
@@ -330,7 +1286,7 @@ int32 UBPDeviceSubsystem::SendScalarCommand(const FBPScalarCommand& Command, FBP
 		BPLog::Error(this, "Tried to send message while not connected!");
 		return -1;
 	}
-	return PackAndSendMessage<FBPScalarCommand>(Response, Command.DeviceIndex, Command.Scalars);
+	return SendCommand(Response, PrepareCommand(Command));
 }
 
 int32 UBPDeviceSubsystem::SendLinearCommand(const FBPLinearCommand& Command, FBPInstancedResponseDelegate Response)
@@ -340,7 +1296,7 @@ int32 UBPDeviceSubsystem::SendLinearCommand(const FBPLinearCommand& Command, FBP
 		BPLog::Error(this, "Tried to send message while not connected!");
 		return -1;
 	}
-	return PackAndSendMessage<FBPLinearCommand>(Response, Command.DeviceIndex, Command.Vectors);
+	return SendCommand(Response, PrepareCommand(Command));
 }
 
 int32 UBPDeviceSubsystem::SendRotateCommand(const FBPRotateCommand& Command, FBPInstancedResponseDelegate Response)
@@ -350,7 +1306,164 @@ int32 UBPDeviceSubsystem::SendRotateCommand(const FBPRotateCommand& Command, FBP
 		BPLog::Error(this, "Tried to send message while not connected!");
 		return -1;
 	}
-	return PackAndSendMessage<FBPRotateCommand>(Response, Command.DeviceIndex, Command.Rotations);
+	return SendCommand(Response, PrepareCommand(Command));
+}
+
+namespace
+{
+	//Element by element, as assigning the whole array destroys every element first and copies each one afresh.
+	template<typename ElementType>
+	void CopyElements(TArray<ElementType>& To, const TArray<ElementType>& From)
+	{
+		To.SetNum(From.Num(), EAllowShrinking::No);
+		for (int32 i = 0; i < From.Num(); i++)
+		{
+			To[i] = From[i];
+		}
+	}
+
+	//As above, but elements To no longer needs are moved into Spare rather than destroyed, and taken back from it as To grows.
+	//For elements holding strings, so a command that changes size from send to send does not free and reallocate them.
+	template<typename ElementType>
+	void CopyElements(TArray<ElementType>& To, const TArray<ElementType>& From, TArray<ElementType>& Spare)
+	{
+		while (To.Num() > From.Num())
+		{
+			Spare.Emplace(MoveTemp(To.Last()));
+			To.Pop(EAllowShrinking::No);
+		}
+		while (To.Num() < From.Num() && Spare.Num() > 0)
+		{
+			To.Emplace(MoveTemp(Spare.Last()));
+			Spare.Pop(EAllowShrinking::No);
+		}
+		CopyElements(To, From);
+	}
+}
+
+FBPScalarCommand& UBPDeviceSubsystem::PrepareCommand(const FBPScalarCommand& Command)
+{
+	FBPScalarCommand& Request = GetScratchMessage<FBPScalarCommand>();
+	Request.DeviceIndex = Command.DeviceIndex;
+	CopyElements(Request.Scalars, Command.Scalars, SpareScalars);
+	for (FBPScalarObject& Scalar : Request.Scalars)
+	{
+		Scalar.Scalar = QuantizeActuatorValue(Command.DeviceIndex, &FBPDeviceMessages::ScalarCmd, Scalar.Index, Scalar.Scalar);
+	}
+	return Request;
+}
+
+FBPLinearCommand& UBPDeviceSubsystem::PrepareCommand(const FBPLinearCommand& Command)
+{
+	FBPLinearCommand& Request = GetScratchMessage<FBPLinearCommand>();
+	Request.DeviceIndex = Command.DeviceIndex;
+	CopyElements(Request.Vectors, Command.Vectors);
+	for (FBPLinearObject& Vector : Request.Vectors)
+	{
+		Vector.Position = QuantizeActuatorValue(Command.DeviceIndex, &FBPDeviceMessages::LinearCmd, Vector.Index, Vector.Position);
+	}
+	return Request;
+}
+
+FBPRotateCommand& UBPDeviceSubsystem::PrepareCommand(const FBPRotateCommand& Command)
+{
+	FBPRotateCommand& Request = GetScratchMessage<FBPRotateCommand>();
+	Request.DeviceIndex = Command.DeviceIndex;
+	CopyElements(Request.Rotations, Command.Rotations);
+	for (FBPRotateObject& Rotation : Request.Rotations)
+	{
+		Rotation.Speed = QuantizeActuatorValue(Command.DeviceIndex, &FBPDeviceMessages::RotateCmd, Rotation.Index, Rotation.Speed);
+	}
+	return Request;
+}
+
+TFuture<FInstancedStruct> UBPDeviceSubsystem::RequestServerInfoAsync()
+{
+	return SendAsync([this](FBPResponseHandler&& Response)
+	{
+		SendQuery<FBPMessageRequestServerInfo>(MoveTemp(Response), FQueryKey{ EBPMessageType::RequestServerInfo }, UButtplugUESettings::GetButtplugClientName(), 3);
+	});
+}
+
+TFuture<FInstancedStruct> UBPDeviceSubsystem::PingServerAsync()
+{
+	return PackAndSendMessageAsync<FBPMessageStatusPing>();
+}
+
+TFuture<FInstancedStruct> UBPDeviceSubsystem::RequestDeviceListAsync()
+{
+	return SendAsync([this](FBPResponseHandler&& Response)
+	{
+		SendQuery<FBPRequestDeviceList>(MoveTemp(Response), FQueryKey{ EBPMessageType::RequestDeviceList });
+	});
+}
+
+TFuture<FInstancedStruct> UBPDeviceSubsystem::StopDeviceAsync(const FBPDeviceObject& Device, bool bStopPatterns /*= true*/)
+{
+	if (bStopPatterns && IsConnected())
+	{
+		StopDevicePatterns(Device);
+	}
+	return SendAsync([this, &Device](FBPResponseHandler&& Response) { SendStop<FBPStopDeviceCmd>(MoveTemp(Response), Device.DeviceIndex, Device.DeviceIndex); });
+}
+
+TFuture<FInstancedStruct> UBPDeviceSubsystem::StopAllDevicesAsync(bool bStopPatterns /*= true*/)
+{
+	if (bStopPatterns && IsConnected())
+	{
+		StopAllPatterns();
+	}
+	return SendAsync([this](FBPResponseHandler&& Response) { SendStop<FBPStopAllDevices>(MoveTemp(Response), INDEX_NONE); });
+}
+
+TFuture<FInstancedStruct> UBPDeviceSubsystem::StartScanningAsync()
+{
+	return PackAndSendMessageAsync<FBPStartScanning>();
+}
+
+TFuture<FInstancedStruct> UBPDeviceSubsystem::StopScanningAsync()
+{
+	return PackAndSendMessageAsync<FBPStopScanning>();
+}
+
+TFuture<FInstancedStruct> UBPDeviceSubsystem::SendScalarCommandAsync(const FBPScalarCommand& Command)
+{
+	return SendAsync([this, &Command](FBPResponseHandler&& Response) { SendCommand(MoveTemp(Response), PrepareCommand(Command)); });
+}
+
+TFuture<FInstancedStruct> UBPDeviceSubsystem::SendLinearCommandAsync(const FBPLinearCommand& Command)
+{
+	return SendAsync([this, &Command](FBPResponseHandler&& Response) { SendCommand(MoveTemp(Response), PrepareCommand(Command)); });
+}
+
+TFuture<FInstancedStruct> UBPDeviceSubsystem::SendRotateCommandAsync(const FBPRotateCommand& Command)
+{
+	return SendAsync([this, &Command](FBPResponseHandler&& Response) { SendCommand(MoveTemp(Response), PrepareCommand(Command)); });
+}
+
+void UBPDeviceSubsystem::StopDevicePatterns(const FBPDeviceObject& Device)
+{
+	//Stopping a command removes it from ManagedCommands, so iterate a copy.
+	TArray<UBPManagedCommand*> Commands;
+	ManagedCommands.GenerateValueArray(Commands);
+	for(int i = 0; i < Commands.Num(); i++)
+	{
+		if(Commands[i]->GetDevice() == Device)
+		{
+			Commands[i]->StopCommand(true, false);
+		}
+	}
+}
+
+void UBPDeviceSubsystem::StopAllPatterns()
+{
+	for (const TPair<FGuid, UBPManagedCommand*> Command : ManagedCommands)
+	{
+		//Do not broadcast on stop completion to avoid changing the array while we are iterating through it.
+		Command.Value->StopCommand(false, false);
+		Command.Value->MarkAsGarbage();
+	}
+	ManagedCommands.Empty();
 }
 
 FGuid UBPDeviceSubsystem::StartScalarPatternCommand(FBPDeviceObject TargetDevice, FBPScalarCommand InCommand, UCurveFloat* InPattern,
@@ -401,7 +1514,8 @@ int32 UBPDeviceSubsystem::SendSensorReadCommand(const FBPSensorReadCommand& Comm
 		BPLog::Error(this, "Tried to send message while not connected!");
 		return -1;
 	}
-	return PackAndSendMessage<FBPSensorReadCommand>(Response, Command.DeviceIndex, Command.SensorIndex, Command.SensorType);
+	const FQueryKey Key{ EBPMessageType::SensorReadCmd, Command.DeviceIndex, Command.SensorIndex, Command.SensorType };
+	return SendQuery<FBPSensorReadCommand>(Response, Key, Command.DeviceIndex, Command.SensorIndex, Command.SensorType);
 }
 
 int32 UBPDeviceSubsystem::SubscribeToSensor(const FBPSensorSubscribeCommand& Command, FBPInstancedResponseDelegate Response)
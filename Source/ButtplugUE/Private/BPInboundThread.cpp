@@ -0,0 +1,191 @@
+// Copyright d/Dev 2026
+
+#include "BPInboundThread.h"
+
+#include "HAL/RunnableThread.h"
+#include "HAL/Event.h"
+
+FBPInboundThread::FBPInboundThread(UObject* InLogContext)
+	: LogContext(InLogContext)
+{
+	if (FPlatformProcess::SupportsMultithreading())
+	{
+		WorkEvent = FPlatformProcess::GetSynchEventFromPool();
+		Thread = FRunnableThread::Create(this, TEXT("ButtplugUE Inbound"), 0, TPri_Normal);
+	}
+}
+
+FBPInboundThread::~FBPInboundThread()
+{
+	Shutdown();
+}
+
+void FBPInboundThread::Parse(TConstArrayView<uint8> Frame, uint32 WantedTypes)
+{
+	FFrame Queued;
+	SpareBuffers.Dequeue(Queued.Bytes);
+	Queued.Bytes.Reset();
+	Queued.Bytes.Append(Frame.GetData(), Frame.Num());
+	Queued.WantedTypes = WantedTypes;
+
+	PendingFrames.fetch_add(1, std::memory_order_relaxed);
+	Frames.Enqueue(MoveTemp(Queued));
+	WorkEvent->Trigger();
+}
+
+void FBPInboundThread::AwaitResponse(int32 Id, TFunctionRef<bool(int32 Id)> IsStillAwaited)
+{
+	const int32 Home = Id & (AwaitedCapacity - 1);
+	for (int32 Distance = 0; Distance < AwaitedCapacity; Distance++)
+	{
+		std::atomic<int32>& Slot = AwaitedIds[(Home + Distance) & (AwaitedCapacity - 1)];
+		const int32 Previous = Slot.load(std::memory_order_relaxed);
+		if (Previous <= 0 || !IsStillAwaited(Previous))
+		{
+			//Published before the Id, and both before the frame carrying its reply can be queued, which is also from this thread.
+			if (Distance > AwaitedMaxDistance.load(std::memory_order_relaxed))
+			{
+				AwaitedMaxDistance.store(Distance, std::memory_order_release);
+			}
+			Slot.store(Id, std::memory_order_release);
+			return;
+		}
+	}
+	//More waiting than the response table holds, which it evicts before letting happen.
+	AwaitedIds[Home].store(Id, std::memory_order_release);
+}
+
+bool FBPInboundThread::IsAwaited(int32 Id) const
+{
+	const int32 Home = Id & (AwaitedCapacity - 1);
+	const int32 MaxDistance = AwaitedMaxDistance.load(std::memory_order_acquire);
+	for (int32 Distance = 0; Distance <= MaxDistance; Distance++)
+	{
+		if (AwaitedIds[(Home + Distance) & (AwaitedCapacity - 1)].load(std::memory_order_acquire) == Id)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FBPInboundThread::WaitUntilParsed(double TimeoutSeconds)
+{
+	const double Deadline = FPlatformTime::Seconds() + TimeoutSeconds;
+	while (PendingFrames.load(std::memory_order_acquire) > 0)
+	{
+		if (FPlatformTime::Seconds() >= Deadline)
+		{
+			return false;
+		}
+		FPlatformProcess::Sleep(0.001f);
+	}
+	return true;
+}
+
+void FBPInboundThread::Shutdown()
+{
+	if (Thread == nullptr)
+	{
+		return;
+	}
+
+	Stop();
+	Thread->WaitForCompletion();
+	delete Thread;
+	Thread = nullptr;
+	FPlatformProcess::ReturnSynchEventToPool(WorkEvent);
+	WorkEvent = nullptr;
+}
+
+uint32 FBPInboundThread::Run()
+{
+	FFrame Frame;
+	while (!bStopping.load())
+	{
+		WorkEvent->Wait();
+		while (!bStopping.load() && Frames.Dequeue(Frame))
+		{
+			ParseFrame(Frame);
+			Frame.Bytes.Reset();
+			SpareBuffers.Enqueue(MoveTemp(Frame.Bytes));
+			PendingFrames.fetch_sub(1, std::memory_order_release);
+		}
+	}
+	return 0;
+}
+
+void FBPInboundThread::Stop()
+{
+	bStopping.store(true);
+	if (WorkEvent != nullptr)
+	{
+		WorkEvent->Trigger();
+	}
+}
+
+void FBPInboundThread::ParseFrame(const FFrame& Frame)
+{
+	const double ReceivedAt = FPlatformTime::Seconds();
+	Headers.Reset();
+	Decoded.Reset();
+	int32 Skipped = 0;
+	const EBPInboundRejectReason Rejected = UBPTypes::DeserializeMessage(LogContext, Frame.Bytes, Decoded,
+		[this, &Frame](EBPMessageType Type, int32 Id)
+		{
+			const bool bDecode = (Frame.WantedTypes & (1u << (uint8)Type)) != 0
+				|| (Id > 0 && IsAwaited(Id));
+			Headers.Add({ Type, Id, bDecode });
+			return bDecode;
+		}, Skipped);
+	SkippedCount.fetch_add(Skipped, std::memory_order_relaxed);
+
+	//A message that failed to decode is missing from Decoded, so match them up rather than assuming one each.
+	int32 DecodedIndex = 0;
+	for (const FHeader& Header : Headers)
+	{
+		FBPInboundRecord* Record = BeginRecord();
+		if (Record == nullptr)
+		{
+			return;
+		}
+
+		Record->Decoded.Type = Header.Type;
+		Record->Decoded.Message.Reset();
+		if (Header.bDecode && Decoded.IsValidIndex(DecodedIndex) && Decoded[DecodedIndex].Type == Header.Type
+			&& Decoded[DecodedIndex].Message.Get<FBPMessageBase>().GetId() == Header.Id)
+		{
+			Record->Decoded.Message = MoveTemp(Decoded[DecodedIndex++].Message);
+		}
+		Record->Id = Header.Id;
+		Record->ReceivedAt = ReceivedAt;
+		Record->Rejected = EBPInboundRejectReason::None;
+		Record->PacketBytes = 0;
+		Records.EndPush();
+	}
+
+	if (Rejected != EBPInboundRejectReason::None)
+	{
+		//After the messages decoded before the problem, which were complete and valid.
+		if (FBPInboundRecord* Record = BeginRecord())
+		{
+			Record->Decoded.Type = EBPMessageType::MAX;
+			Record->Decoded.Message.Reset();
+			Record->Rejected = Rejected;
+			Record->PacketBytes = Frame.Bytes.Num();
+			Records.EndPush();
+		}
+	}
+}
+
+FBPInboundRecord* FBPInboundThread::BeginRecord()
+{
+	//Holding off here rather than dropping messages or growing without bound, the socket buffers behind us in the meantime.
+	FBPInboundRecord* Record = Records.BeginPush();
+	while (Record == nullptr && !bStopping.load())
+	{
+		FPlatformProcess::Sleep(0.001f);
+		Record = Records.BeginPush();
+	}
+	return Record;
+}
@@ -0,0 +1,559 @@
+// Copyright d/Dev 2026
+
+#include "BPJsonReader.h"
+
+namespace
+{
+	int32 HexValue(uint8 Char)
+	{
+		if (Char >= '0' && Char <= '9') { return Char - '0'; }
+		if (Char >= 'a' && Char <= 'f') { return Char - 'a' + 10; }
+		if (Char >= 'A' && Char <= 'F') { return Char - 'A' + 10; }
+		return -1;
+	}
+
+	template<typename AllocatorType>
+	void AppendUTF8(TArray<ANSICHAR, AllocatorType>& Out, uint32 Codepoint)
+	{
+		if (Codepoint < 0x80)
+		{
+			Out.Add((ANSICHAR)Codepoint);
+		}
+		else if (Codepoint < 0x800)
+		{
+			Out.Add((ANSICHAR)(0xC0 | (Codepoint >> 6)));
+			Out.Add((ANSICHAR)(0x80 | (Codepoint & 0x3F)));
+		}
+		else if (Codepoint < 0x10000)
+		{
+			Out.Add((ANSICHAR)(0xE0 | (Codepoint >> 12)));
+			Out.Add((ANSICHAR)(0x80 | ((Codepoint >> 6) & 0x3F)));
+			Out.Add((ANSICHAR)(0x80 | (Codepoint & 0x3F)));
+		}
+		else
+		{
+			Out.Add((ANSICHAR)(0xF0 | (Codepoint >> 18)));
+			Out.Add((ANSICHAR)(0x80 | ((Codepoint >> 12) & 0x3F)));
+			Out.Add((ANSICHAR)(0x80 | ((Codepoint >> 6) & 0x3F)));
+			Out.Add((ANSICHAR)(0x80 | (Codepoint & 0x3F)));
+		}
+	}
+}
+
+FBPJsonReader::FBPJsonReader(TConstArrayView<uint8> InData)
+	: FBPJsonReader(InData, FLimits())
+{
+}
+
+FBPJsonReader::FBPJsonReader(TConstArrayView<uint8> InData, const FLimits& InLimits)
+	: Data(InData.GetData())
+	, Size(InData.Num())
+	, Limits(InLimits)
+{
+	Limits.MaxDepth = FMath::Clamp(Limits.MaxDepth, 1, MaxDepth);
+	Limits.MaxArrayLength = FMath::Max(Limits.MaxArrayLength, 0);
+}
+
+FBPJsonReader::EValueType FBPJsonReader::PeekType()
+{
+	if (HasError())
+	{
+		return EValueType::None;
+	}
+
+	SkipWhitespace();
+	if (Pos >= Size)
+	{
+		return EValueType::None;
+	}
+
+	switch (Data[Pos])
+	{
+	case '{': return EValueType::Object;
+	case '[': return EValueType::Array;
+	case '"': return EValueType::String;
+	case 't':
+	case 'f': return EValueType::Bool;
+	case 'n': return EValueType::Null;
+	default: break;
+	}
+
+	if (Data[Pos] == '-' || (Data[Pos] >= '0' && Data[Pos] <= '9'))
+	{
+		return EValueType::Number;
+	}
+
+	return EValueType::None;
+}
+
+bool FBPJsonReader::ReadBeginObject()
+{
+	if (PeekType() != EValueType::Object)
+	{
+		return false;
+	}
+	Pos++;
+	return OpenScope();
+}
+
+bool FBPJsonReader::ReadBeginArray()
+{
+	if (PeekType() != EValueType::Array)
+	{
+		return false;
+	}
+	Pos++;
+	return OpenScope();
+}
+
+bool FBPJsonReader::NextKey(FAnsiStringView& OutKey)
+{
+	if (HasError() || Depth == 0)
+	{
+		return false;
+	}
+
+	SkipWhitespace();
+	if (Pos < Size && Data[Pos] == '}')
+	{
+		Pos++;
+		CloseScope();
+		return false;
+	}
+
+	if (!ConsumeSeparator())
+	{
+		return false;
+	}
+
+	int32 Start, End;
+	bool bHasEscapes;
+	if (PeekType() != EValueType::String || !ScanString(Start, End, bHasEscapes))
+	{
+		return Fail();
+	}
+
+	SkipWhitespace();
+	if (Pos >= Size || Data[Pos] != ':')
+	{
+		return Fail();
+	}
+	Pos++;
+
+	//Keys are only ever compared against our own ASCII field names, so escapes are left as-is.
+	OutKey = FAnsiStringView((const ANSICHAR*)Data + Start, End - Start);
+	return true;
+}
+
+bool FBPJsonReader::NextElement()
+{
+	if (HasError() || Depth == 0)
+	{
+		return false;
+	}
+
+	SkipWhitespace();
+	if (Pos < Size && Data[Pos] == ']')
+	{
+		Pos++;
+		CloseScope();
+		return false;
+	}
+
+	return ConsumeSeparator();
+}
+
+bool FBPJsonReader::ReadNumber(double& OutValue)
+{
+	if (PeekType() != EValueType::Number)
+	{
+		return false;
+	}
+
+	int32 Start, End;
+	bool bIsInteger;
+	if (!ScanNumber(Start, End, bIsInteger))
+	{
+		return false;
+	}
+
+	//Atod wants a terminated string, and no sane number needs more than this.
+	ANSICHAR Buffer[64];
+	const int32 Len = End - Start;
+	if (Len >= UE_ARRAY_COUNT(Buffer))
+	{
+		return Fail();
+	}
+	FMemory::Memcpy(Buffer, Data + Start, Len);
+	Buffer[Len] = '\0';
+	OutValue = FCStringAnsi::Atod(Buffer);
+	return true;
+}
+
+bool FBPJsonReader::ReadInt(int64& OutValue)
+{
+	if (PeekType() != EValueType::Number)
+	{
+		return false;
+	}
+
+	const int32 Rewind = Pos;
+	int32 Start, End;
+	bool bIsInteger;
+	if (!ScanNumber(Start, End, bIsInteger))
+	{
+		return false;
+	}
+
+	//18 digits always fits in int64, anything longer or fractional goes the slow way.
+	const bool bNegative = Data[Start] == '-';
+	const int32 DigitStart = bNegative ? Start + 1 : Start;
+	if (bIsInteger && End - DigitStart <= 18)
+	{
+		int64 Value = 0;
+		for (int32 i = DigitStart; i < End; i++)
+		{
+			Value = Value * 10 + (Data[i] - '0');
+		}
+		OutValue = bNegative ? -Value : Value;
+		return true;
+	}
+
+	Pos = Rewind;
+	double Number;
+	if (!ReadNumber(Number))
+	{
+		return false;
+	}
+	OutValue = (int64)FMath::Clamp(Number, (double)MIN_int64, (double)MAX_int64);
+	return true;
+}
+
+bool FBPJsonReader::ReadBool(bool& bOutValue)
+{
+	if (PeekType() != EValueType::Bool)
+	{
+		return false;
+	}
+
+	if (Data[Pos] == 't')
+	{
+		bOutValue = true;
+		return ScanLiteral("true", 4);
+	}
+
+	bOutValue = false;
+	return ScanLiteral("false", 5);
+}
+
+bool FBPJsonReader::ReadNull()
+{
+	if (PeekType() != EValueType::Null)
+	{
+		return false;
+	}
+	return ScanLiteral("null", 4);
+}
+
+bool FBPJsonReader::ReadString(FString& OutValue)
+{
+	if (PeekType() != EValueType::String)
+	{
+		return false;
+	}
+
+	int32 Start, End;
+	bool bHasEscapes;
+	if (!ScanString(Start, End, bHasEscapes))
+	{
+		return false;
+	}
+
+	if (!bHasEscapes)
+	{
+		FUTF8ToTCHAR Converted((const ANSICHAR*)Data + Start, End - Start);
+		OutValue = FString(Converted.Length(), Converted.Get());
+		return true;
+	}
+
+	TArray<ANSICHAR, TInlineAllocator<256>> Unescaped;
+	for (int32 i = Start; i < End; i++)
+	{
+		if (Data[i] != '\\')
+		{
+			Unescaped.Add((ANSICHAR)Data[i]);
+			continue;
+		}
+
+		//ScanString guarantees there is a character after every backslash.
+		i++;
+		switch (Data[i])
+		{
+		case '"':	Unescaped.Add('"'); break;
+		case '\\':	Unescaped.Add('\\'); break;
+		case '/':	Unescaped.Add('/'); break;
+		case 'b':	Unescaped.Add('\b'); break;
+		case 'f':	Unescaped.Add('\f'); break;
+		case 'n':	Unescaped.Add('\n'); break;
+		case 'r':	Unescaped.Add('\r'); break;
+		case 't':	Unescaped.Add('\t'); break;
+		case 'u':
+		{
+			auto ReadHex4 = [this, End](int32 At, uint32& OutCode) -> bool
+			{
+				if (At + 4 > End)
+				{
+					return false;
+				}
+				OutCode = 0;
+				for (int32 j = At; j < At + 4; j++)
+				{
+					const int32 Nibble = HexValue(Data[j]);
+					if (Nibble < 0)
+					{
+						return false;
+					}
+					OutCode = (OutCode << 4) | Nibble;
+				}
+				return true;
+			};
+
+			uint32 Code;
+			if (!ReadHex4(i + 1, Code))
+			{
+				Pos = i;
+				return Fail();
+			}
+			i += 4;
+
+			if (Code >= 0xD800 && Code <= 0xDBFF)
+			{
+				uint32 Low;
+				if (i + 2 < End && Data[i + 1] == '\\' && Data[i + 2] == 'u' && ReadHex4(i + 3, Low) && Low >= 0xDC00 && Low <= 0xDFFF)
+				{
+					Code = 0x10000 + ((Code - 0xD800) << 10) + (Low - 0xDC00);
+					i += 6;
+				}
+				else
+				{
+					Code = 0xFFFD;
+				}
+			}
+			else if (Code >= 0xDC00 && Code <= 0xDFFF)
+			{
+				Code = 0xFFFD;
+			}
+
+			AppendUTF8(Unescaped, Code);
+			break;
+		}
+		default:
+			Pos = i;
+			return Fail();
+		}
+	}
+
+	FUTF8ToTCHAR Converted(Unescaped.GetData(), Unescaped.Num());
+	OutValue = FString(Converted.Length(), Converted.Get());
+	return true;
+}
+
+bool FBPJsonReader::SkipValue()
+{
+	int32 Start, End;
+	bool bFlag;
+	FAnsiStringView Key;
+
+	switch (PeekType())
+	{
+	case EValueType::Object:
+		ReadBeginObject();
+		while (NextKey(Key))
+		{
+			if (!SkipValue())
+			{
+				return false;
+			}
+		}
+		return !HasError();
+	case EValueType::Array:
+		ReadBeginArray();
+		while (NextElement())
+		{
+			if (!SkipValue())
+			{
+				return false;
+			}
+		}
+		return !HasError();
+	case EValueType::String:
+		return ScanString(Start, End, bFlag);
+	case EValueType::Number:
+		return ScanNumber(Start, End, bFlag);
+	case EValueType::Bool:
+		return ReadBool(bFlag);
+	case EValueType::Null:
+		return ReadNull();
+	default:
+		return Fail();
+	}
+}
+
+bool FBPJsonReader::Fail(EError Reason)
+{
+	//Keep the first reason, it is the one that explains the rest.
+	if (Error == EError::None)
+	{
+		Error = Reason;
+	}
+	return false;
+}
+
+bool FBPJsonReader::CheckArrayLength(int32 Num)
+{
+	return Num < Limits.MaxArrayLength || Fail(EError::TooLong);
+}
+
+void FBPJsonReader::SkipWhitespace()
+{
+	while (Pos < Size && (Data[Pos] == ' ' || Data[Pos] == '\t' || Data[Pos] == '\n' || Data[Pos] == '\r'))
+	{
+		Pos++;
+	}
+}
+
+bool FBPJsonReader::OpenScope()
+{
+	if (Depth >= Limits.MaxDepth)
+	{
+		return Fail(EError::TooDeep);
+	}
+	Depth++;
+	CommaMask &= ~(1ull << Depth);
+	return true;
+}
+
+void FBPJsonReader::CloseScope()
+{
+	Depth--;
+}
+
+bool FBPJsonReader::ConsumeSeparator()
+{
+	const uint64 Bit = 1ull << Depth;
+	if (CommaMask & Bit)
+	{
+		if (Pos >= Size || Data[Pos] != ',')
+		{
+			return Fail();
+		}
+		Pos++;
+		SkipWhitespace();
+	}
+	CommaMask |= Bit;
+
+	//A separator has to be followed by something, which also catches trailing commas.
+	if (Pos >= Size || Data[Pos] == '}' || Data[Pos] == ']')
+	{
+		return Fail();
+	}
+	return true;
+}
+
+bool FBPJsonReader::ScanString(int32& OutStart, int32& OutEnd, bool& bOutHasEscapes)
+{
+	//Caller has already checked we are sitting on the opening quote.
+	Pos++;
+	OutStart = Pos;
+	bOutHasEscapes = false;
+
+	while (Pos < Size)
+	{
+		const uint8 Char = Data[Pos];
+		if (Char == '"')
+		{
+			OutEnd = Pos;
+			Pos++;
+			return true;
+		}
+		if (Char == '\\')
+		{
+			bOutHasEscapes = true;
+			Pos += 2;
+			continue;
+		}
+		if (Char < 0x20)
+		{
+			return Fail();
+		}
+		Pos++;
+	}
+
+	return Fail();
+}
+
+bool FBPJsonReader::ScanNumber(int32& OutStart, int32& OutEnd, bool& bOutIsInteger)
+{
+	auto IsDigit = [this](int32 At) { return At < Size && Data[At] >= '0' && Data[At] <= '9'; };
+
+	OutStart = Pos;
+	bOutIsInteger = true;
+
+	if (Pos < Size && Data[Pos] == '-')
+	{
+		Pos++;
+	}
+	if (!IsDigit(Pos))
+	{
+		return Fail();
+	}
+	while (IsDigit(Pos))
+	{
+		Pos++;
+	}
+
+	if (Pos < Size && Data[Pos] == '.')
+	{
+		bOutIsInteger = false;
+		Pos++;
+		if (!IsDigit(Pos))
+		{
+			return Fail();
+		}
+		while (IsDigit(Pos))
+		{
+			Pos++;
+		}
+	}
+
+	if (Pos < Size && (Data[Pos] == 'e' || Data[Pos] == 'E'))
+	{
+		bOutIsInteger = false;
+		Pos++;
+		if (Pos < Size && (Data[Pos] == '+' || Data[Pos] == '-'))
+		{
+			Pos++;
+		}
+		if (!IsDigit(Pos))
+		{
+			return Fail();
+		}
+		while (IsDigit(Pos))
+		{
+			Pos++;
+		}
+	}
+
+	OutEnd = Pos;
+	return true;
+}
+
+bool FBPJsonReader::ScanLiteral(const ANSICHAR* Literal, int32 Len)
+{
+	if (Pos + Len > Size || FMemory::Memcmp(Data + Pos, Literal, Len) != 0)
+	{
+		return Fail();
+	}
+	Pos += Len;
+	return true;
+}
@@ -0,0 +1,359 @@
+// Copyright d/Dev 2026
+
+#include "BPJsonWriter.h"
+
+FBPJsonWriter::FBPJsonWriter(TArray<uint8>& InBuffer)
+	: Buffer(InBuffer)
+{
+}
+
+void FBPJsonWriter::BeginObject()
+{
+	WriteSeparator();
+	AppendByte('{');
+	bNeedsComma = false;
+}
+
+void FBPJsonWriter::EndObject()
+{
+	AppendByte('}');
+	bNeedsComma = true;
+}
+
+void FBPJsonWriter::BeginArray()
+{
+	WriteSeparator();
+	AppendByte('[');
+	bNeedsComma = false;
+}
+
+void FBPJsonWriter::EndArray()
+{
+	AppendByte(']');
+	bNeedsComma = true;
+}
+
+void FBPJsonWriter::WriteKey(const ANSICHAR* Key)
+{
+	WriteSeparator();
+	AppendByte('"');
+	AppendRaw(Key, FCStringAnsi::Strlen(Key));
+	AppendByte('"');
+	AppendByte(':');
+	bNeedsComma = false;
+}
+
+void FBPJsonWriter::WriteInt(int64 Value)
+{
+	WriteSeparator();
+	ANSICHAR Digits[21];
+	AppendRaw(Digits, FormatInt(Value, Digits));
+	bNeedsComma = true;
+}
+
+void FBPJsonWriter::WriteDouble(double Value)
+{
+	WriteSeparator();
+	ANSICHAR Digits[32];
+	AppendRaw(Digits, FormatDouble(Value, Digits));
+	bNeedsComma = true;
+}
+
+void FBPJsonWriter::WriteInt(int64 Value, const void* Source)
+{
+	FBPJsonSlot* Slot = FindSlot(Source);
+	if (Slot == nullptr)
+	{
+		WriteInt(Value);
+		return;
+	}
+
+	WriteSeparator();
+	ANSICHAR Digits[21];
+	AppendPadded(Digits, FormatInt(FMath::Clamp<int64>(Value, MIN_int32, MAX_int32), Digits), IntSlotWidth, *Slot);
+	Slot->bIsInteger = true;
+	bNeedsComma = true;
+}
+
+void FBPJsonWriter::WriteDouble(double Value, const void* Source)
+{
+	FBPJsonSlot* Slot = FindSlot(Source);
+	if (Slot == nullptr)
+	{
+		WriteDouble(Value);
+		return;
+	}
+
+	WriteSeparator();
+	ANSICHAR Digits[32];
+	AppendPadded(Digits, FormatDouble(Value, Digits), DoubleSlotWidth, *Slot);
+	bNeedsComma = true;
+}
+
+void FBPJsonWriter::WriteBool(bool bValue)
+{
+	WriteSeparator();
+	if (bValue)
+	{
+		AppendRaw("true", 4);
+	}
+	else
+	{
+		AppendRaw("false", 5);
+	}
+	bNeedsComma = true;
+}
+
+void FBPJsonWriter::WriteString(FStringView Value)
+{
+	WriteSeparator();
+	AppendByte('"');
+
+	const TCHAR* Chars = Value.GetData();
+	const int32 Len = Value.Len();
+	for (int32 i = 0; i < Len; i++)
+	{
+		uint32 Code = (uint32)Chars[i];
+
+		//Plain printable ASCII is by far the common case, so get it out of the way first.
+		if (Code >= 0x20 && Code < 0x80 && Code != '"' && Code != '\\')
+		{
+			AppendByte((uint8)Code);
+			continue;
+		}
+
+		switch (Code)
+		{
+		case '"':	AppendRaw("\\\"", 2); continue;
+		case '\\':	AppendRaw("\\\\", 2); continue;
+		case '\b':	AppendRaw("\\b", 2); continue;
+		case '\f':	AppendRaw("\\f", 2); continue;
+		case '\n':	AppendRaw("\\n", 2); continue;
+		case '\r':	AppendRaw("\\r", 2); continue;
+		case '\t':	AppendRaw("\\t", 2); continue;
+		default: break;
+		}
+
+		if (Code < 0x20)
+		{
+			static const ANSICHAR Hex[] = "0123456789abcdef";
+			const ANSICHAR Escaped[6] = { '\\', 'u', '0', '0', Hex[Code >> 4], Hex[Code & 0xF] };
+			AppendRaw(Escaped, 6);
+			continue;
+		}
+
+		//TCHAR is UTF-16 on most platforms, so stitch surrogate pairs back together before encoding.
+		if (Code >= 0xD800 && Code <= 0xDBFF)
+		{
+			const uint32 Low = i + 1 < Len ? (uint32)Chars[i + 1] : 0;
+			if (Low >= 0xDC00 && Low <= 0xDFFF)
+			{
+				Code = 0x10000 + ((Code - 0xD800) << 10) + (Low - 0xDC00);
+				i++;
+			}
+			else
+			{
+				Code = 0xFFFD;
+			}
+		}
+		else if (Code >= 0xDC00 && Code <= 0xDFFF)
+		{
+			Code = 0xFFFD;
+		}
+
+		AppendCodepoint(Code);
+	}
+
+	AppendByte('"');
+	bNeedsComma = true;
+}
+
+void FBPJsonWriter::WriteNull()
+{
+	WriteSeparator();
+	AppendRaw("null", 4);
+	bNeedsComma = true;
+}
+
+FString FBPJsonWriter::ToDebugString(const TArray<uint8>& InBuffer)
+{
+	FUTF8ToTCHAR Converted((const ANSICHAR*)InBuffer.GetData(), InBuffer.Num());
+	return FString(Converted.Length(), Converted.Get());
+}
+
+void FBPJsonWriter::AddSlot(const void* Source, FBPJsonSlot& OutSlot)
+{
+	OutSlot = FBPJsonSlot();
+	PendingSlots.Add({ Source, &OutSlot });
+}
+
+void FBPJsonWriter::PatchInt(TArrayView<uint8> InBuffer, const FBPJsonSlot& Slot, int64 Value)
+{
+	check(Slot.IsValid() && Slot.Offset + Slot.Width <= InBuffer.Num());
+	ANSICHAR Digits[21];
+	const int32 Len = FMath::Min(FormatInt(FMath::Clamp<int64>(Value, MIN_int32, MAX_int32), Digits), Slot.Width);
+	FMemory::Memcpy(InBuffer.GetData() + Slot.Offset, Digits, Len);
+	FMemory::Memset(InBuffer.GetData() + Slot.Offset + Len, ' ', Slot.Width - Len);
+}
+
+void FBPJsonWriter::PatchDouble(TArrayView<uint8> InBuffer, const FBPJsonSlot& Slot, double Value)
+{
+	check(Slot.IsValid() && Slot.Offset + Slot.Width <= InBuffer.Num());
+	ANSICHAR Digits[32];
+	int32 Len = FormatDouble(Value, Digits);
+	if (Len > Slot.Width)
+	{
+		Len = FormatDouble(0.0, Digits);
+	}
+	FMemory::Memcpy(InBuffer.GetData() + Slot.Offset, Digits, Len);
+	FMemory::Memset(InBuffer.GetData() + Slot.Offset + Len, ' ', Slot.Width - Len);
+}
+
+FBPJsonSlot* FBPJsonWriter::FindSlot(const void* Source)
+{
+	for (int32 i = 0; i < PendingSlots.Num(); i++)
+	{
+		if (PendingSlots[i].Source == Source)
+		{
+			FBPJsonSlot* Slot = PendingSlots[i].Slot;
+			PendingSlots.RemoveAtSwap(i);
+			return Slot;
+		}
+	}
+	return nullptr;
+}
+
+void FBPJsonWriter::AppendPadded(const ANSICHAR* Data, int32 Len, int32 Width, FBPJsonSlot& OutSlot)
+{
+	Len = FMath::Min(Len, Width);
+	OutSlot.Offset = Buffer.Num();
+	OutSlot.Width = Width;
+	AppendRaw(Data, Len);
+	Buffer.AddUninitialized(Width - Len);
+	FMemory::Memset(Buffer.GetData() + OutSlot.Offset + Len, ' ', Width - Len);
+}
+
+int32 FBPJsonWriter::FormatInt(int64 Value, ANSICHAR (&OutDigits)[21])
+{
+	//Written backwards then shifted down, 20 digits + sign covers all of int64.
+	int32 Pos = UE_ARRAY_COUNT(OutDigits);
+	uint64 Magnitude = Value < 0 ? (uint64)0 - (uint64)Value : (uint64)Value;
+	do
+	{
+		OutDigits[--Pos] = (ANSICHAR)('0' + (Magnitude % 10));
+		Magnitude /= 10;
+	} while (Magnitude != 0);
+
+	if (Value < 0)
+	{
+		OutDigits[--Pos] = '-';
+	}
+
+	const int32 Len = UE_ARRAY_COUNT(OutDigits) - Pos;
+	FMemory::Memmove(OutDigits, OutDigits + Pos, Len);
+	return Len;
+}
+
+int32 FBPJsonWriter::FormatDouble(double Value, ANSICHAR (&OutDigits)[32])
+{
+	//JSON has no representation for NaN/Inf, and no device would accept one anyway.
+	if (!FMath::IsFinite(Value))
+	{
+		Value = 0.0;
+	}
+
+	//Almost everything we send is an actuator value in 0...1, often already snapped to a step grid (0.25, 0.35...).
+	//Print those as fixed point with up to 9 decimals, trailing zeros trimmed, which is both shorter and far cheaper than printf.
+	//The range is limited so every digit printed is still within double precision, anything else goes through printf as before.
+	const double Magnitude = FMath::Abs(Value);
+	if (Magnitude == 0.0 || (Magnitude >= 1e-3 && Magnitude < 1e6))
+	{
+		constexpr uint64 Scale = 1000000000;
+		const uint64 Scaled = (uint64)(Magnitude * (double)Scale + 0.5);
+		uint64 Whole = Scaled / Scale;
+		uint64 Fraction = Scaled % Scale;
+
+		int32 Len = 0;
+		if (Value < 0.0 && Scaled != 0)
+		{
+			OutDigits[Len++] = '-';
+		}
+
+		ANSICHAR WholeDigits[10];
+		int32 WholeLen = 0;
+		do
+		{
+			WholeDigits[WholeLen++] = (ANSICHAR)('0' + (Whole % 10));
+			Whole /= 10;
+		} while (Whole != 0);
+		while (WholeLen > 0)
+		{
+			OutDigits[Len++] = WholeDigits[--WholeLen];
+		}
+
+		if (Fraction != 0)
+		{
+			int32 FractionLen = 9;
+			while (Fraction % 10 == 0)
+			{
+				Fraction /= 10;
+				FractionLen--;
+			}
+			OutDigits[Len++] = '.';
+			for (int32 i = FractionLen - 1; i >= 0; i--)
+			{
+				OutDigits[Len + i] = (ANSICHAR)('0' + (Fraction % 10));
+				Fraction /= 10;
+			}
+			Len += FractionLen;
+		}
+		return Len;
+	}
+
+	const int32 Len = FCStringAnsi::Snprintf(OutDigits, UE_ARRAY_COUNT(OutDigits), "%.9g", Value);
+	return FMath::Clamp(Len, 0, (int32)UE_ARRAY_COUNT(OutDigits) - 1);
+}
+
+void FBPJsonWriter::WriteSeparator()
+{
+	if (bNeedsComma)
+	{
+		AppendByte(',');
+	}
+}
+
+void FBPJsonWriter::AppendRaw(const ANSICHAR* Data, int32 Len)
+{
+	Buffer.Append((const uint8*)Data, Len);
+}
+
+void FBPJsonWriter::AppendByte(uint8 Byte)
+{
+	Buffer.Add(Byte);
+}
+
+void FBPJsonWriter::AppendCodepoint(uint32 Codepoint)
+{
+	if (Codepoint < 0x80)
+	{
+		AppendByte((uint8)Codepoint);
+	}
+	else if (Codepoint < 0x800)
+	{
+		AppendByte((uint8)(0xC0 | (Codepoint >> 6)));
+		AppendByte((uint8)(0x80 | (Codepoint & 0x3F)));
+	}
+	else if (Codepoint < 0x10000)
+	{
+		AppendByte((uint8)(0xE0 | (Codepoint >> 12)));
+		AppendByte((uint8)(0x80 | ((Codepoint >> 6) & 0x3F)));
+		AppendByte((uint8)(0x80 | (Codepoint & 0x3F)));
+	}
+	else
+	{
+		AppendByte((uint8)(0xF0 | (Codepoint >> 18)));
+		AppendByte((uint8)(0x80 | ((Codepoint >> 12) & 0x3F)));
+		AppendByte((uint8)(0x80 | ((Codepoint >> 6) & 0x3F)));
+		AppendByte((uint8)(0x80 | (Codepoint & 0x3F)));
+	}
+}
@@ -0,0 +1,86 @@
+// Copyright d/Dev 2026
+
+#include "BPLatencyHistogram.h"
+
+void FBPLatencyHistogram::Record(double Seconds)
+{
+	const uint32 Micros = (uint32)FMath::Clamp(Seconds * 1e6, 0.0, (double)MAX_uint32);
+	Buckets[ToBucket(Micros)]++;
+	Count++;
+	MaxMicros = FMath::Max(MaxMicros, Micros);
+}
+
+void FBPLatencyHistogram::Reset()
+{
+	for (uint32& Bucket : Buckets)
+	{
+		Bucket = 0;
+	}
+	Count = 0;
+	MaxMicros = 0;
+}
+
+double FBPLatencyHistogram::GetPercentile(double Percentile) const
+{
+	if (Count == 0)
+	{
+		return 0.0;
+	}
+
+	const int64 Target = FMath::Max<int64>(1, (int64)FMath::CeilToDouble(FMath::Clamp(Percentile, 0.0, 100.0) / 100.0 * Count));
+	int64 Seen = 0;
+	for (int32 Bucket = 0; Bucket < BucketCount; Bucket++)
+	{
+		Seen += Buckets[Bucket];
+		if (Seen >= Target)
+		{
+			//Middle of the bucket, but never past the largest value actually seen.
+			const uint32 Micros = GetBucketLowest(Bucket) + GetBucketWidth(Bucket) / 2;
+			return FMath::Min(Micros, MaxMicros) / 1e6;
+		}
+	}
+	return GetMax();
+}
+
+FBPLatencySummary FBPLatencyHistogram::Summarize() const
+{
+	FBPLatencySummary Summary;
+	Summary.Count = (int32)FMath::Min<int64>(Count, MAX_int32);
+	Summary.P50Ms = GetPercentile(50.0) * 1000.0;
+	Summary.P95Ms = GetPercentile(95.0) * 1000.0;
+	Summary.P99Ms = GetPercentile(99.0) * 1000.0;
+	Summary.MaxMs = GetMax() * 1000.0;
+	return Summary;
+}
+
+int32 FBPLatencyHistogram::ToBucket(uint32 Micros)
+{
+	if (Micros < SubBucketCount)
+	{
+		return Micros;
+	}
+	//The top SubBucketBits bits below the leading one pick the linear bucket within its power of two.
+	const int32 Exponent = FMath::FloorLog2(Micros);
+	const int32 SubBucket = (Micros >> (Exponent - SubBucketBits)) & (SubBucketCount - 1);
+	return SubBucketCount + (Exponent - SubBucketBits) * SubBucketCount + SubBucket;
+}
+
+uint32 FBPLatencyHistogram::GetBucketLowest(int32 Bucket)
+{
+	if (Bucket < SubBucketCount)
+	{
+		return Bucket;
+	}
+	const int32 Exponent = (Bucket - SubBucketCount) / SubBucketCount + SubBucketBits;
+	const uint32 SubBucket = (Bucket - SubBucketCount) % SubBucketCount;
+	return (SubBucketCount + SubBucket) << (Exponent - SubBucketBits);
+}
+
+uint32 FBPLatencyHistogram::GetBucketWidth(int32 Bucket)
+{
+	if (Bucket < SubBucketCount)
+	{
+		return 1;
+	}
+	return 1u << ((Bucket - SubBucketCount) / SubBucketCount);
+}
@@ -3,11 +3,21 @@
 #include "BPLogging.h"
 
 #include "Engine/Engine.h"
+#include "Async/Async.h"
 
 #include "ButtplugUESettings.h"
 
 DEFINE_LOG_CATEGORY(LogButtplugUE);
 
+namespace
+{
+	//Callers pass either no context or a null one when there is no object to name, both log without a prefix.
+	UObject* GetContextObject(const TOptional<UObject*>& Context)
+	{
+		return Context.Get(nullptr);
+	}
+}
+
 void UBPLogging::Message(UObject* Context, const FString Message, bool bLogOnScreen, FLinearColor Color)
 {
 	BPLog::Message(Context, Message, FStringFormatNamedArguments(), bLogOnScreen, Color.ToFColor(false));
@@ -26,7 +36,7 @@ void UBPLogging::Error(UObject* Context, const FString Message, bool bLogOnScree
 void BPLog::Message(const TOptional<UObject*> Context, const FString Message, FStringFormatNamedArguments Args, bool bLogOnScreen, FColor Color)
 {
 	FString Log = BPLog::GetFormattedLog(Message, Args);
-	UObject* ContextPtr = *Context.GetPtrOrNull();
+	UObject* ContextPtr = GetContextObject(Context);
 	if (UButtplugUESettings::GetLoggingVerbosity() == EBPLogVerbosity::All)
 	{
 		if(ContextPtr != nullptr)
@@ -48,7 +58,7 @@ void BPLog::Message(const TOptional<UObject*> Context, const FString Message, FS
 void BPLog::Warning(const TOptional<UObject*> Context, const FString Message, FStringFormatNamedArguments Args, bool bLogOnScreen, FColor Color)
 {
 	FString Log = BPLog::GetFormattedLog(Message, Args);
-	UObject* ContextPtr = *Context.GetPtrOrNull();
+	UObject* ContextPtr = GetContextObject(Context);
 	if (UButtplugUESettings::GetLoggingVerbosity() >= EBPLogVerbosity::Warnings)
 	{
 		if (ContextPtr != nullptr)
@@ -70,11 +80,12 @@ void BPLog::Warning(const TOptional<UObject*> Context, const FString Message, FS
 void BPLog::Error(const TOptional<UObject*> Context, const FString Message, FStringFormatNamedArguments Args, bool bLogOnScreen, FColor Color)
 {
 	FString Log = BPLog::GetFormattedLog(Message, Args);
+	UObject* ContextPtr = GetContextObject(Context);
 	if (UButtplugUESettings::GetLoggingVerbosity() >= EBPLogVerbosity::Errors)
 	{
-		if (Context.IsSet())
+		if (ContextPtr != nullptr)
 		{
-			UE_LOG(LogButtplugUE, Error, TEXT("%s: %s"), *Context.GetValue()->GetName(), *Log);
+			UE_LOG(LogButtplugUE, Error, TEXT("%s: %s"), *ContextPtr->GetName(), *Log);
 		}
 		else
 		{
@@ -83,7 +94,7 @@ void BPLog::Error(const TOptional<UObject*> Context, const FString Message, FStr
 
 		if (bLogOnScreen)
 		{
-			LogOnScreen(Context.IsSet() ? Context.GetValue() : nullptr, Log, Color);
+			LogOnScreen(ContextPtr, Log, Color);
 		}
 	}
 }
@@ -98,6 +109,18 @@ void BPLog::LogOnScreen(const UObject* Context, const FString Message, FColor Co
 	}
 	Msg += Message;
 
+	//The on-screen log belongs to the game thread, so messages from the inbound thread are passed over to it.
+	if (!IsInGameThread())
+	{
+		AsyncTask(ENamedThreads::GameThread, [Msg, Color]()
+		{
+			if (GEngine)
+			{
+				GEngine->AddOnScreenDebugMessage(-1, 5.0f, Color, *Msg);
+			}
+		});
+		return;
+	}
 	GEngine->AddOnScreenDebugMessage(-1, 5.0f, Color, *Msg);
 }
 
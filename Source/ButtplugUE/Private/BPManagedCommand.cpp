@@ -21,42 +21,73 @@ UBPManagedCommand* UBPManagedCommand::CreateManagedCommand(UObject* Context, FBP
 
 	Out->TickRate = 1.0f / UpdatesPerSecond;
 
+	Out->CompilePacketTemplate();
 	Out->bActive = true;
 
 	return Out;
 }
 
-void UBPManagedCommand::UpdateDevice()
+namespace
 {
-	float TimeMin, TimeMax, PatternDuration;
-	Pattern->GetTimeRange(TimeMin, TimeMax);
-	PatternDuration = TimeMax - TimeMin;
-	float NewStrength = Pattern->GetFloatValue(FGenericPlatformMath::Fmod(Runtime, PatternDuration));
+	int32 FindStepCount(const TArray<FBPCommandMessage>& Actuators, int32 Index)
+	{
+		return Actuators.IsValidIndex(Index) ? Actuators[Index].StepCount : -1;
+	}
+}
 
-	if(Command.GetPtr<FBPScalarCommand>() != nullptr)
+void UBPManagedCommand::CompilePacketTemplate()
+{
+	//Only the first actuator in each command is driven by the pattern, so that is the one value slot.
+	//The device we were given describes its own actuators, so the step grid can be looked up once here.
+	if (FBPScalarCommand* SclCmd = Command.GetMutablePtr<FBPScalarCommand>(); SclCmd && SclCmd->Scalars.Num() > 0)
+	{
+		StepCount = FindStepCount(Device.DeviceMessages.ScalarCmd, SclCmd->Scalars[0].Index);
+		DrivenValue = &SclCmd->Scalars[0].Scalar;
+		PacketTemplate.Compile(*SclCmd, { DrivenValue });
+	}
+	else if (FBPRotateCommand* RotCmd = Command.GetMutablePtr<FBPRotateCommand>(); RotCmd && RotCmd->Rotations.Num() > 0)
+	{
+		StepCount = FindStepCount(Device.DeviceMessages.RotateCmd, RotCmd->Rotations[0].Index);
+		DrivenValue = &RotCmd->Rotations[0].Speed;
+		PacketTemplate.Compile(*RotCmd, { DrivenValue });
+	}
+	else if (FBPLinearCommand* LinCmd = Command.GetMutablePtr<FBPLinearCommand>(); LinCmd && LinCmd->Vectors.Num() > 0)
 	{
-		FBPScalarCommand* SclCmd = Command.GetMutablePtr<FBPScalarCommand>();
-		SclCmd->Scalars[0].Scalar = NewStrength;
-		GetBP()->SendScalarCommand(*SclCmd, FBPInstancedResponseDelegate());
+		StepCount = FindStepCount(Device.DeviceMessages.LinearCmd, LinCmd->Vectors[0].Index);
+		DrivenValue = &LinCmd->Vectors[0].Position;
+		PacketTemplate.Compile(*LinCmd, { DrivenValue });
 	}
-	else if (Command.GetPtr<FBPRotateCommand>() != nullptr)
+	else
 	{
-		FBPRotateCommand* RotCmd = Command.GetMutablePtr<FBPRotateCommand>();
-		RotCmd->Rotations[0].Speed = NewStrength;
-		GetBP()->SendRotateCommand(*RotCmd, FBPInstancedResponseDelegate());
+		BPLog::Error(this, "Pattern command has no actuator to drive, it will not send anything.");
 	}
-	else if (Command.GetPtr<FBPLinearCommand>() != nullptr)
+}
+
+void UBPManagedCommand::UpdateDevice()
+{
+	if (!PacketTemplate.IsCompiled())
 	{
-		FBPLinearCommand* LinCmd = Command.GetMutablePtr<FBPLinearCommand>();
-		LinCmd->Vectors[0].Position = NewStrength;
-		GetBP()->SendLinearCommand(*LinCmd, FBPInstancedResponseDelegate());
+		return;
 	}
+
+	float TimeMin, TimeMax, PatternDuration;
+	Pattern->GetTimeRange(TimeMin, TimeMax);
+	PatternDuration = TimeMax - TimeMin;
+	float NewStrength = Pattern->GetFloatValue(FGenericPlatformMath::Fmod(Runtime, PatternDuration));
+
+	const double Value = UBPTypes::QuantizeActuatorValue(NewStrength, StepCount);
+	*DrivenValue = Value;
+	PacketTemplate.SetValue(0, Value);
+	GetBP()->SendPacketTemplate(PacketTemplate, &Command);
 }
 
-void UBPManagedCommand::StopCommand(bool bBroadcastStop /*= true*/)
+void UBPManagedCommand::StopCommand(bool bBroadcastStop /*= true*/, bool bStopDevice /*= true*/)
 {
 	bActive = false;
-	GetBP()->StopDevice(Device, FBPInstancedResponseDelegate(), false);
+	if (bStopDevice)
+	{
+		GetBP()->StopDevice(Device, FBPInstancedResponseDelegate(), false);
+	}
 	if(bBroadcastStop)
 	{
 		OnCommandStopped.Broadcast(Id);
@@ -89,7 +120,8 @@ void UBPManagedCommand::Tick(float DeltaTime)
 		return;
 	}
 
-	if (TimeSinceLastTick >= TickRate)
+	//The subsystem slows a device down while it is falling behind, there is no point working out values it will not send.
+	if (TimeSinceLastTick >= FMath::Max(TickRate, GetBP()->GetDeviceCommandInterval(Device.DeviceIndex)))
 	{
 		UpdateDevice();
 		TimeSinceLastTick = 0.0f;
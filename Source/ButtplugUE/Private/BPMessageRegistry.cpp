@@ -0,0 +1,99 @@
+// Copyright d/Dev 2026
+
+#include "BPMessageRegistry.h"
+
+#include "BPJsonWriter.h"
+#include "BPSerializationPlan.h"
+#include "BPLogging.h"
+#include "BPStats.h"
+
+const FBPMessageRegistry& FBPMessageRegistry::Get()
+{
+	static const FBPMessageRegistry Registry;
+	return Registry;
+}
+
+FBPMessageRegistry::FBPMessageRegistry()
+{
+	Types.SetNum((int32)EBPMessageType::MAX);
+
+	Register<FBPMessageStatusOk>(EBPMessageType::Ok);
+	Register<FBPMessageStatusError>(EBPMessageType::Error);
+	Register<FBPMessageStatusPing>(EBPMessageType::Ping);
+	Register<FBPMessageRequestServerInfo>(EBPMessageType::RequestServerInfo);
+	Register<FBPMessageServerInfo>(EBPMessageType::ServerInfo);
+	Register<FBPStartScanning>(EBPMessageType::StartScanning);
+	Register<FBPStopScanning>(EBPMessageType::StopScanning);
+	Register<FBPScanningFinished>(EBPMessageType::ScanningFinished);
+	Register<FBPRequestDeviceList>(EBPMessageType::RequestDeviceList);
+	Register<FBPDeviceList>(EBPMessageType::DeviceList);
+	Register<FBPDeviceAdded>(EBPMessageType::DeviceAdded);
+	Register<FBPDeviceRemove>(EBPMessageType::DeviceRemoved);
+	Register<FBPStopDeviceCmd>(EBPMessageType::StopDeviceCmd);
+	Register<FBPStopAllDevices>(EBPMessageType::StopAllDevices);
+	Register<FBPScalarCommand>(EBPMessageType::ScalarCmd);
+	Register<FBPLinearCommand>(EBPMessageType::LinearCmd);
+	Register<FBPRotateCommand>(EBPMessageType::RotateCmd);
+	Register<FBPSensorMessageBase>(EBPMessageType::SensorMessageBase);
+	Register<FBPSensorReadCommand>(EBPMessageType::SensorReadCmd);
+	Register<FBPSensorReading>(EBPMessageType::SensorReading);
+	Register<FBPSensorSubscribeCommand>(EBPMessageType::SensorSubscribeCmd);
+	Register<FBPSensorUnsubscribeCommand>(EBPMessageType::SensorUnsubscribeCmd);
+
+	for (const FBPMessageTypeInfo& Info : Types)
+	{
+		checkf(Info.Struct != nullptr, TEXT("EBPMessageType %d has no registered struct."), (int32)Info.Type);
+	}
+}
+
+template<typename T>
+void FBPMessageRegistry::Register(EBPMessageType Type)
+{
+	const ANSICHAR* Title = T::MessageTitle;
+	FBPMessageTypeInfo& Info = Types[(uint8)Type];
+	Info.Type = Type;
+	Info.Title = FName(Title);
+	Info.TitleKey.Append(Title, FCStringAnsi::Strlen(Title) + 1);
+	Info.Struct = T::StaticStruct();
+	Info.Plan = &FBPSerializationPlan::Get(Info.Struct);
+
+	TitleLookup.Add(Info.Title, Type);
+	StructLookup.Add(Info.Struct, Type);
+}
+
+const FBPMessageTypeInfo* FBPMessageRegistry::FindByTitle(FAnsiStringView Title) const
+{
+	//FNAME_Find never adds to the name table, so junk titles from the wire cannot grow it.
+	const FName Name(Title.Len(), Title.GetData(), FNAME_Find);
+	if (const EBPMessageType* Found = Name.IsNone() ? nullptr : TitleLookup.Find(Name))
+	{
+		return &Types[(uint8)*Found];
+	}
+
+	CountUnknownTitle(Title);
+	return nullptr;
+}
+
+const FBPMessageTypeInfo* FBPMessageRegistry::FindByStruct(const UScriptStruct* Struct) const
+{
+	const EBPMessageType* Found = StructLookup.Find(Struct);
+	return Found != nullptr ? &Types[(uint8)*Found] : nullptr;
+}
+
+void FBPMessageRegistry::WriteMessage(FBPJsonWriter& Writer, const FBPMessageTypeInfo& Info, const void* Message)
+{
+	Writer.BeginObject();
+	Writer.WriteKey(Info.TitleKey.GetData());
+	Info.Plan->Write(Writer, Message);
+	Writer.EndObject();
+}
+
+void FBPMessageRegistry::CountUnknownTitle(FAnsiStringView Title) const
+{
+	UnknownTitleCount.fetch_add(1, std::memory_order_relaxed);
+	INC_DWORD_STAT(STAT_BPUnknownMessages);
+
+	FStringFormatNamedArguments Args;
+	Args.Add("Title", FString(Title));
+	BPLog::Warning(nullptr, "Received unknown message type \"{Title}\", skipping it.", Args, false);
+}
@@ -0,0 +1,128 @@
+// Copyright d/Dev 2026
+
+#include "BPOutboundQueue.h"
+
+#include "BPJsonWriter.h"
+#include "BPMessageRegistry.h"
+
+namespace
+{
+	//Takes actuator commands for a device (or every device) out of the messages in Buffer, which end at MessagesEnd,
+	//compacting the kept ones towards the front in place. They only ever move backwards. Returns where the kept messages now end.
+	int32 RemoveCommands(TArray<uint8>& Buffer, TArray<FBPOutboundEntry>& Entries, int32 MessagesEnd, int32 DeviceIndex, TArray<int32>& OutRemovedIds)
+	{
+		int32 Write = 1;	//Just past the '['
+		int32 Kept = 0;
+		for (int32 i = 0; i < Entries.Num(); i++)
+		{
+			FBPOutboundEntry Entry = Entries[i];
+			const int32 End = i + 1 < Entries.Num() ? Entries[i + 1].Start - 1 : MessagesEnd;
+			const bool bActuator = Entry.Type == EBPMessageType::ScalarCmd || Entry.Type == EBPMessageType::LinearCmd || Entry.Type == EBPMessageType::RotateCmd;
+			if (bActuator && (DeviceIndex == INDEX_NONE || Entry.DeviceIndex == DeviceIndex))
+			{
+				OutRemovedIds.Add(Entry.Id);
+				continue;
+			}
+
+			if (Kept > 0)
+			{
+				Buffer[Write++] = ',';
+			}
+			const int32 Length = End - Entry.Start;
+			FMemory::Memmove(Buffer.GetData() + Write, Buffer.GetData() + Entry.Start, Length);
+			Entry.Start = Write;
+			Entries[Kept++] = Entry;
+			Write += Length;
+		}
+
+		Entries.SetNum(Kept);
+		return Write;
+	}
+}
+
+void FBPOutboundPacket::RemoveDeviceCommands(int32 DeviceIndex, TArray<int32>& OutRemovedIds)
+{
+	if (Entries.Num() == 0)
+	{
+		return;
+	}
+
+	//Finished, so the messages stop short of the closing ']'.
+	const int32 End = RemoveCommands(Bytes, Entries, Bytes.Num() - 1, DeviceIndex, OutRemovedIds);
+	if (Entries.Num() == 0)
+	{
+		Bytes.Reset();
+		return;
+	}
+	Bytes.SetNum(End + 1);
+	Bytes[End] = ']';
+}
+
+void FBPOutboundQueue::Add(const FBPMessageTypeInfo& Info, const void* Message, int32 Id, int32 DeviceIndex)
+{
+	BeginMessage();
+	Entries.Add({ Buffer.Num(), Id, DeviceIndex, Info.Type });
+	FBPJsonWriter Writer(Buffer);
+	FBPMessageRegistry::WriteMessage(Writer, Info, Message);
+	Count++;
+}
+
+void FBPOutboundQueue::AddPacket(TConstArrayView<uint8> Packet, EBPMessageType Type, int32 Id, int32 DeviceIndex)
+{
+	//Our own writer produced it, so it is exactly [{...}] with nothing around the brackets.
+	if (Packet.Num() < 2)
+	{
+		return;
+	}
+	BeginMessage();
+	Entries.Add({ Buffer.Num(), Id, DeviceIndex, Type });
+	Buffer.Append(Packet.GetData() + 1, Packet.Num() - 2);
+	Count++;
+}
+
+void FBPOutboundQueue::RemoveDeviceCommands(int32 DeviceIndex, TArray<int32>& OutRemovedIds)
+{
+	if (Count == 0)
+	{
+		return;
+	}
+
+	Buffer.SetNum(RemoveCommands(Buffer, Entries, Buffer.Num(), DeviceIndex, OutRemovedIds));
+	Count = Entries.Num();
+}
+
+bool FBPOutboundQueue::Finish(FBPOutboundPacket& OutPacket)
+{
+	if (Count == 0)
+	{
+		return false;
+	}
+	Buffer.Add(']');
+	Swap(Buffer, OutPacket.Bytes);
+	Swap(Entries, OutPacket.Entries);
+	Buffer.Reset();
+	Entries.Reset();
+	Count = 0;
+	return true;
+}
+
+void FBPOutboundQueue::Reset()
+{
+	Buffer.Reset();
+	Entries.Reset();
+	Count = 0;
+}
+
+void FBPOutboundQueue::BeginMessage()
+{
+	if (Count == 0)
+	{
+		Buffer.Reset();
+		Entries.Reset();
+		Buffer.Add('[');
+	}
+	else
+	{
+		Buffer.Add(',');
+	}
+}
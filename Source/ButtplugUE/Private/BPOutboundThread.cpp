@@ -0,0 +1,461 @@
+// Copyright d/Dev 2026
+
+#include "BPOutboundThread.h"
+
+#include "HAL/RunnableThread.h"
+#include "HAL/Event.h"
+#include "IWebSocket.h"
+
+#include "BPLogging.h"
+#include "BPMessageRegistry.h"
+#include "BPStats.h"
+
+namespace
+{
+	//Submitted values for devices that do not report a DeviceMessageTimingGap are still sent no more often than this.
+	constexpr double MinSubmitIntervalSeconds = 0.01;
+
+	const TArray<FBPScalarObject>& GetActuators(const FBPScalarCommand& Command) { return Command.Scalars; }
+	const TArray<FBPLinearObject>& GetActuators(const FBPLinearCommand& Command) { return Command.Vectors; }
+	const TArray<FBPRotateObject>& GetActuators(const FBPRotateCommand& Command) { return Command.Rotations; }
+}
+
+FBPOutboundThread::FBPOutboundThread()
+{
+	if (FPlatformProcess::SupportsMultithreading())
+	{
+		WorkEvent = FPlatformProcess::GetSynchEventFromPool();
+		Thread = FRunnableThread::Create(this, TEXT("ButtplugUE Outbound"), 0, TPri_AboveNormal);
+	}
+}
+
+FBPOutboundThread::~FBPOutboundThread()
+{
+	Shutdown(0.0);
+	//Kept until now rather than returned in Shutdown, as a submitter on another thread may still be triggering it.
+	if (WorkEvent != nullptr)
+	{
+		FPlatformProcess::ReturnSynchEventToPool(WorkEvent);
+		WorkEvent = nullptr;
+	}
+}
+
+void FBPOutboundThread::Send(FBPOutboundPacket&& Packet)
+{
+	FPacket Queued;
+	Queued.Packet = MoveTemp(Packet);
+	Enqueue(MoveTemp(Queued), false);
+}
+
+void FBPOutboundThread::SendStop(FBPOutboundPacket&& Packet, int32 DeviceIndex)
+{
+	FPacket Queued;
+	Queued.Packet = MoveTemp(Packet);
+	Queued.StoppedDevice = DeviceIndex;
+	Enqueue(MoveTemp(Queued), true);
+}
+
+void FBPOutboundThread::Enqueue(FPacket&& Packet, bool bPriority)
+{
+	Packet.SocketGeneration = SocketGeneration.load();
+	if (Thread == nullptr)
+	{
+		//Sent in order as they come, so there is nothing for a stop to overtake.
+		SendPacket(Packet);
+		return;
+	}
+
+	PendingCount.fetch_add(1, std::memory_order_relaxed);
+	//Numbered and then pushed, which is only in order across both queues because there is one producer.
+	Packet.Sequence = NextSequence.fetch_add(1, std::memory_order_relaxed);
+	if (bPriority)
+	{
+		PriorityPackets.Enqueue(MoveTemp(Packet));
+	}
+	else
+	{
+		Packets.Enqueue(MoveTemp(Packet));
+	}
+	WorkEvent->Trigger();
+}
+
+FBPOutboundPacket FBPOutboundThread::TakeSparePacket()
+{
+	FBPOutboundPacket Packet;
+	SparePackets.Dequeue(Packet);
+	return Packet;
+}
+
+bool FBPOutboundThread::WaitUntilSent(double TimeoutSeconds)
+{
+	const double Deadline = FPlatformTime::Seconds() + TimeoutSeconds;
+	while (PendingCount.load(std::memory_order_acquire) > 0)
+	{
+		if (FPlatformTime::Seconds() >= Deadline)
+		{
+			return false;
+		}
+		FPlatformProcess::Sleep(0.001f);
+	}
+	return true;
+}
+
+void FBPOutboundThread::Shutdown(double TimeoutSeconds)
+{
+	if (Thread == nullptr)
+	{
+		return;
+	}
+
+	DrainDeadline.store(FPlatformTime::Seconds() + TimeoutSeconds);
+	Stop();
+	Thread->WaitForCompletion();
+	delete Thread;
+	Thread = nullptr;
+
+	//Anything the thread did not get to in time.
+	FPacket Dropped;
+	int32 DroppedCount = 0;
+	while (PriorityPackets.Dequeue(Dropped) || Packets.Dequeue(Dropped))
+	{
+		DroppedCount++;
+	}
+	PendingCount.store(0);
+	if (DroppedCount > 0)
+	{
+		FStringFormatNamedArguments Args;
+		Args.Add("Count", DroppedCount);
+		BPLog::Warning(nullptr, "Dropped {Count} outbound packets that could not be sent before shutdown.", Args, false);
+	}
+}
+
+uint32 FBPOutboundThread::Run()
+{
+	uint32 WaitMs = MAX_uint32;
+	while (!bStopping.load())
+	{
+		WorkEvent->Wait(WaitMs);
+		SendPending();
+		WaitMs = SendSubmitted();
+	}
+	//One last pass for anything queued while stopping, bounded by the drain deadline.
+	SendPending();
+	return 0;
+}
+
+void FBPOutboundThread::Stop()
+{
+	bStopping.store(true);
+	if (WorkEvent != nullptr)
+	{
+		WorkEvent->Trigger();
+	}
+}
+
+void FBPOutboundThread::SendPending()
+{
+	FPacket Packet;
+	for (;;)
+	{
+		if (bStopping.load() && FPlatformTime::Seconds() >= DrainDeadline.load())
+		{
+			return;
+		}
+		//Checked before every packet, so a stop queued mid-drain goes next.
+		if (PriorityPackets.Dequeue(Packet))
+		{
+			//Only normal packets already waiting can have been queued before it. If there are none, there is nothing to take back.
+			if (!Packets.IsEmpty())
+			{
+				StopBarriers.Add({ Packet.Sequence, Packet.StoppedDevice });
+			}
+		}
+		else if (Packets.Dequeue(Packet))
+		{
+			ApplyStopBarriers(Packet);
+		}
+		else
+		{
+			StopBarriers.Reset();
+			return;
+		}
+		SendPacket(Packet);
+		PendingCount.fetch_sub(1, std::memory_order_release);
+	}
+}
+
+void FBPOutboundThread::ApplyStopBarriers(FPacket& Packet)
+{
+	if (StopBarriers.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<int32> RemovedIds;
+	int32 Passed = 0;
+	for (const FStopBarrier& Barrier : StopBarriers)
+	{
+		if (Barrier.Sequence < Packet.Sequence)
+		{
+			//Queued after this stop, as is everything behind it, so it is done with.
+			Passed++;
+			continue;
+		}
+		Packet.Packet.RemoveDeviceCommands(Barrier.DeviceIndex, RemovedIds);
+	}
+	StopBarriers.RemoveAt(0, Passed);
+
+	for (int32 Id : RemovedIds)
+	{
+		DroppedIds.Enqueue(Id);
+	}
+}
+
+void FBPOutboundThread::SendPacket(FPacket& Packet)
+{
+	//Everything in it may have been taken back out by a stop.
+	if (Packet.Packet.Num() > 0)
+	{
+		SendOnSocket(Packet.Packet.Bytes, Packet.SocketGeneration);
+	}
+
+	Packet.Packet.Reset();
+	SparePackets.Enqueue(MoveTemp(Packet.Packet));
+}
+
+int32 FBPOutboundThread::AllocateMessageId()
+{
+	//As if anyone will ever reach this stage.
+	return (int32)(MessageIdCounter.fetch_add(1, std::memory_order_relaxed) % (uint32)INT32_MAX) + 1;
+}
+
+bool FBPOutboundThread::Submit(const FBPSubmittedValue& Value)
+{
+	//Not Thread, which Shutdown clears on the game thread. The event is only ever missing where there are no threads at all.
+	if (WorkEvent == nullptr || bStopping.load())
+	{
+		return false;
+	}
+	if (Value.Type != EBPMessageType::MAX)
+	{
+		bHasSubmitted.store(true);
+	}
+	SubmittedValues.Enqueue(Value);
+	WorkEvent->Trigger();
+	return true;
+}
+
+void FBPOutboundThread::ClearSubmitted(int32 DeviceIndex)
+{
+	//Goes through the same queue, so it lands after every value submitted before it and before any submitted after.
+	FBPSubmittedValue Clear;
+	Clear.DeviceIndex = DeviceIndex;
+	Submit(Clear);
+}
+
+void FBPOutboundThread::DelaySubmitted(int32 DeviceIndex, double ReadyTime)
+{
+	if (!bHasSubmitted.load())
+	{
+		return;
+	}
+	FBPSubmittedValue Delay;
+	Delay.DeviceIndex = DeviceIndex;
+	Delay.ReadyTime = ReadyTime;
+	Submit(Delay);
+}
+
+bool FBPOutboundThread::SendOnSocket(TConstArrayView<uint8> Bytes, uint32 Generation)
+{
+	FScopeLock Lock(&SocketLock);
+	if (Generation != SocketGeneration.load() || !Socket.IsValid() || !Socket->IsConnected())
+	{
+		return false;
+	}
+	//Already UTF-8, so hand the bytes over as a text frame rather than letting the socket convert a FString.
+	Socket->Send(Bytes.GetData(), Bytes.Num(), false);
+	return true;
+}
+
+void FBPOutboundThread::SetSocket(TSharedPtr<IWebSocket> InSocket)
+{
+	TSharedPtr<IWebSocket> Old;
+	{
+		FScopeLock Lock(&SocketLock);
+		Old = MoveTemp(Socket);
+		Socket = MoveTemp(InSocket);
+		SocketGeneration++;
+	}
+	//Old goes out of scope here, on the caller's thread.
+}
+
+void FBPOutboundThread::SetDevices(const TMap<int32, FBPDeviceObject>& InDevices)
+{
+	{
+		FScopeLock Lock(&SharedLock);
+		SharedDevices = InDevices;
+	}
+	bDevicesChanged.store(true);
+	if (WorkEvent != nullptr)
+	{
+		WorkEvent->Trigger();
+	}
+}
+
+uint32 FBPOutboundThread::SendSubmitted()
+{
+	if (bDevicesChanged.exchange(false))
+	{
+		FScopeLock Lock(&SharedLock);
+		Devices = SharedDevices;
+	}
+
+	FBPSubmittedValue Value;
+	while (SubmittedValues.Dequeue(Value))
+	{
+		ApplySubmitted(Value);
+	}
+	if (SubmittedCommands.IsEmpty())
+	{
+		return MAX_uint32;
+	}
+
+	//Values for one socket are never sent on the next.
+	const uint32 Generation = SocketGeneration.load();
+	bool bConnected;
+	{
+		FScopeLock Lock(&SocketLock);
+		bConnected = Socket.IsValid() && Socket->IsConnected();
+	}
+	if (!bConnected)
+	{
+		SubmittedCommands.Reset();
+		return MAX_uint32;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	auto GetReadyTime = [this, Now](int32 DeviceIndex)
+		{
+			const FBPDeviceObject* Device = Devices.Find(DeviceIndex);
+			const double Gap = Device != nullptr ? Device->DeviceMessageTimingGap / 1000.0 : 0.0;
+			return Now + FMath::Max(Gap, MinSubmitIntervalSeconds);
+		};
+	TArray<int32, TInlineAllocator<8>> SentDevices;
+	SubmittedCommands.DrainIf(
+		[this, Now](int32 DeviceIndex)
+		{
+			const double* ReadyTime = DeviceReadyTimes.Find(DeviceIndex);
+			return ReadyTime == nullptr || *ReadyTime <= Now;
+		},
+		[this, &SentDevices, &GetReadyTime](auto& Command)
+		{
+			using FCommandType = std::decay_t<decltype(Command)>;
+			const FBPMessageTypeInfo& Info = FBPMessageRegistry::GetInfo<FCommandType>();
+			SubmittedPacket.Add(Info, &Command, Command.Id, Command.DeviceIndex);
+			INC_DWORD_STAT(STAT_BPOutboundMessages);
+			SentDevices.AddUnique(Command.DeviceIndex);
+
+			//The game thread keeps its own pacing and record of what each actuator was last sent, both of which this has just overtaken.
+			const double ReadyTime = GetReadyTime(Command.DeviceIndex);
+			for (const auto& Actuator : GetActuators(Command))
+			{
+				SubmittedSends.Enqueue(FBPSubmittedSend{ Info.Type, Command.DeviceIndex, Actuator.Index, ReadyTime });
+			}
+		});
+
+	for (int32 DeviceIndex : SentDevices)
+	{
+		DeviceReadyTimes.Add(DeviceIndex, GetReadyTime(DeviceIndex));
+	}
+
+	if (SubmittedPacket.Finish(SubmittedBuffer) && SendOnSocket(SubmittedBuffer.Bytes, Generation))
+	{
+		INC_DWORD_STAT(STAT_BPOutboundPackets);
+		INC_DWORD_STAT_BY(STAT_BPOutboundBytes, SubmittedBuffer.Bytes.Num());
+	}
+
+	if (SubmittedCommands.IsEmpty())
+	{
+		return MAX_uint32;
+	}
+	//Something is still waiting on its device, wake up when the soonest one could be ready.
+	double NextReady = MAX_dbl;
+	for (const TPair<int32, double>& ReadyTime : DeviceReadyTimes)
+	{
+		if (ReadyTime.Value > Now)
+		{
+			NextReady = FMath::Min(NextReady, ReadyTime.Value);
+		}
+	}
+	return NextReady == MAX_dbl ? 1 : (uint32)FMath::Max(FMath::CeilToInt((NextReady - Now) * 1000.0), 1);
+}
+
+void FBPOutboundThread::ApplySubmitted(const FBPSubmittedValue& Value)
+{
+	bool bMerged = false;
+	auto MakeId = [this]() { return AllocateMessageId(); };
+	switch (Value.Type)
+	{
+	case EBPMessageType::ScalarCmd:
+	{
+		ScratchScalar.DeviceIndex = Value.DeviceIndex;
+		//Filled in place, so the ActuatorType string keeps its buffer from one value to the next.
+		ScratchScalar.Scalars.SetNum(1, EAllowShrinking::No);
+		FBPScalarObject& Scalar = ScratchScalar.Scalars[0];
+		Scalar.Index = Value.ActuatorIndex;
+		Scalar.Scalar = UBPTypes::QuantizeActuatorValue(Value.Value, GetStepCount(Value.DeviceIndex, &FBPDeviceMessages::ScalarCmd, Value.ActuatorIndex));
+		Value.ActuatorType.ToString(Scalar.ActuatorType);
+		SubmittedCommands.Add(ScratchScalar, MakeId, bMerged);
+		break;
+	}
+	case EBPMessageType::LinearCmd:
+		ScratchLinear.DeviceIndex = Value.DeviceIndex;
+		ScratchLinear.Vectors.Reset();
+		ScratchLinear.Vectors.Emplace(Value.ActuatorIndex, Value.Duration,
+			UBPTypes::QuantizeActuatorValue(Value.Value, GetStepCount(Value.DeviceIndex, &FBPDeviceMessages::LinearCmd, Value.ActuatorIndex)));
+		SubmittedCommands.Add(ScratchLinear, MakeId, bMerged);
+		break;
+	case EBPMessageType::RotateCmd:
+		ScratchRotate.DeviceIndex = Value.DeviceIndex;
+		ScratchRotate.Rotations.Reset();
+		ScratchRotate.Rotations.Emplace(Value.ActuatorIndex,
+			UBPTypes::QuantizeActuatorValue(Value.Value, GetStepCount(Value.DeviceIndex, &FBPDeviceMessages::RotateCmd, Value.ActuatorIndex)), Value.bClockwise);
+		SubmittedCommands.Add(ScratchRotate, MakeId, bMerged);
+		break;
+	default:
+		//The game thread has sent the device a command, nothing submitted goes to it until the gap after that has passed.
+		if (Value.ReadyTime > 0.0)
+		{
+			double& ReadyTime = DeviceReadyTimes.FindOrAdd(Value.DeviceIndex, 0.0);
+			ReadyTime = FMath::Max(ReadyTime, Value.ReadyTime);
+			return;
+		}
+		//A clear, because the device is being stopped. Its pacing goes with it, as the stop has just gone out.
+		if (Value.DeviceIndex == INDEX_NONE)
+		{
+			SubmittedCommands.Reset();
+			DeviceReadyTimes.Reset();
+		}
+		else
+		{
+			SubmittedCommands.RemoveDevice(Value.DeviceIndex);
+			DeviceReadyTimes.Remove(Value.DeviceIndex);
+		}
+		return;
+	}
+
+	if (bMerged)
+	{
+		INC_DWORD_STAT(STAT_BPCoalescedCommands);
+	}
+}
+
+int32 FBPOutboundThread::GetStepCount(int32 DeviceIndex, TArray<FBPCommandMessage> FBPDeviceMessages::*Actuators, int32 ActuatorIndex) const
+{
+	const FBPDeviceObject* Device = Devices.Find(DeviceIndex);
+	if (Device == nullptr || !(Device->DeviceMessages.*Actuators).IsValidIndex(ActuatorIndex))
+	{
+		return -1;
+	}
+	return (Device->DeviceMessages.*Actuators)[ActuatorIndex].StepCount;
+}
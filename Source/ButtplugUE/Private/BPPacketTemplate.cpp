@@ -0,0 +1,56 @@
+// Copyright d/Dev 2026
+
+#include "BPPacketTemplate.h"
+
+#include "BPLogging.h"
+
+void FBPPacketTemplate::Compile(const FBPMessageTypeInfo& Info, const void* Message, const int32* Id, TConstArrayView<const void*> Values)
+{
+	Bytes.Reset();
+	ValueSlots.SetNum(Values.Num());
+	Type = Info.Type;
+
+	FBPJsonWriter Writer(Bytes);
+	Writer.AddSlot(Id, IdSlot);
+	for (int32 i = 0; i < Values.Num(); i++)
+	{
+		Writer.AddSlot(Values[i], ValueSlots[i]);
+	}
+
+	Writer.BeginArray();
+	FBPMessageRegistry::WriteMessage(Writer, Info, Message);
+	Writer.EndArray();
+
+	for (const FBPJsonSlot& Slot : ValueSlots)
+	{
+		if (!Slot.IsValid())
+		{
+			FStringFormatNamedArguments Args;
+			Args.Add("Title", Info.Title.ToString());
+			BPLog::Error(TOptional<UObject*>(), "Packet template for {Title} was given a value that is not part of the message, it will not be updated.", Args);
+		}
+	}
+}
+
+void FBPPacketTemplate::SetId(int32 Id)
+{
+	FBPJsonWriter::PatchInt(Bytes, IdSlot, Id);
+}
+
+void FBPPacketTemplate::SetValue(int32 Index, double Value)
+{
+	const FBPJsonSlot& Slot = ValueSlots[Index];
+	if (!Slot.IsValid())
+	{
+		return;
+	}
+
+	if (Slot.bIsInteger)
+	{
+		FBPJsonWriter::PatchInt(Bytes, Slot, FMath::RoundToInt64(Value));
+	}
+	else
+	{
+		FBPJsonWriter::PatchDouble(Bytes, Slot, Value);
+	}
+}
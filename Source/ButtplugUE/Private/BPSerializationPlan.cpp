@@ -0,0 +1,385 @@
+// Copyright d/Dev 2026
+
+#include "BPSerializationPlan.h"
+
+#include "UObject/UnrealType.h"
+#include "UObject/EnumProperty.h"
+#include "Misc/ScopeRWLock.h"
+#include "BPJsonWriter.h"
+#include "BPJsonReader.h"
+#include "BPLogging.h"
+#include "BPStats.h"
+
+namespace
+{
+	//Plans are never freed once built, so references handed out by Get() stay valid for the module's lifetime.
+	FRWLock PlanLock;
+	TMap<const UScriptStruct*, TUniquePtr<FBPSerializationPlan>> Plans;
+
+	//Every ActuatorType and SensorType in the Buttplug v3 spec. Built once, so these names are always in the name table.
+	const TArray<FName>& GetKnownNames()
+	{
+		static const TArray<FName> Names = {
+			"Unknown",
+			"Vibrate", "Rotate", "Oscillate", "Constrict", "Inflate", "Position",
+			"Battery", "RSSI", "Button", "Pressure"
+		};
+		return Names;
+	}
+
+	//Names read from the wire that were not in the name table yet are added to it, up to this many over the module's lifetime.
+	//Enough for whatever the protocol adds, while a server sending a fresh string every time cannot grow the table without bound.
+	constexpr int32 MaxNewNames = 64;
+	std::atomic<int32> NewNameCount { 0 };
+}
+
+std::atomic<int32> FBPSerializationPlan::RefusedNameCount { 0 };
+
+FBPSerializationPlan::FBPSerializationPlan(const UScriptStruct* InStruct)
+	: Struct(InStruct)
+{
+}
+
+const FBPSerializationPlan& FBPSerializationPlan::Get(const UScriptStruct* InStruct)
+{
+	check(InStruct);
+	{
+		FReadScopeLock ReadLock(PlanLock);
+		if (const TUniquePtr<FBPSerializationPlan>* Found = Plans.Find(InStruct))
+		{
+			return **Found;
+		}
+	}
+
+	FWriteScopeLock WriteLock(PlanLock);
+	return FindOrBuild(InStruct);
+}
+
+const FBPSerializationPlan& FBPSerializationPlan::FindOrBuild(const UScriptStruct* InStruct)
+{
+	if (const TUniquePtr<FBPSerializationPlan>* Found = Plans.Find(InStruct))
+	{
+		return **Found;
+	}
+
+	//Registered before the fields are built so nested lookups of the same type resolve to this plan.
+	FBPSerializationPlan* Plan = Plans.Add(InStruct, TUniquePtr<FBPSerializationPlan>(new FBPSerializationPlan(InStruct))).Get();
+
+	//Walk base to derived so inherited fields (Id etc.) come first in the output, like the spec examples.
+	TArray<const UStruct*, TInlineAllocator<4>> Chain;
+	for (const UStruct* Current = InStruct; Current != nullptr; Current = Current->GetSuperStruct())
+	{
+		Chain.Insert(Current, 0);
+	}
+
+	for (const UStruct* Current : Chain)
+	{
+		for (TFieldIterator<FProperty> It(Current, EFieldIteratorFlags::ExcludeSuper); It; ++It)
+		{
+			const FProperty* Property = *It;
+			FFieldPlan Field;
+			if (Property->ArrayDim != 1 || !BuildValuePlan(Property, Field.Value))
+			{
+				FStringFormatNamedArguments Args;
+				Args.Add("Property", Property->GetName());
+				Args.Add("Struct", InStruct->GetName());
+				BPLog::Warning(nullptr, "Property {Property} on {Struct} has no JSON mapping and will be skipped.", Args, false);
+				continue;
+			}
+
+			Field.Name = Property->GetName();
+			FTCHARToUTF8 Key(*Field.Name);
+			Field.Key.Append(Key.Get(), Key.Length());
+			Field.Key.Add('\0');
+			Field.Offset = Property->GetOffset_ForInternal();
+			Plan->Fields.Add(MoveTemp(Field));
+		}
+	}
+
+	return *Plan;
+}
+
+bool FBPSerializationPlan::BuildValuePlan(const FProperty* Property, FValuePlan& OutPlan)
+{
+	OutPlan.Property = Property;
+
+	if (Property->IsA<FIntProperty>())
+	{
+		OutPlan.Kind = EValueKind::Int32;
+	}
+	else if (Property->IsA<FDoubleProperty>())
+	{
+		OutPlan.Kind = EValueKind::Double;
+	}
+	else if (Property->IsA<FFloatProperty>())
+	{
+		OutPlan.Kind = EValueKind::Float;
+	}
+	else if (Property->IsA<FEnumProperty>())
+	{
+		OutPlan.Kind = EValueKind::Enum;
+	}
+	else if (const FNumericProperty* Numeric = CastField<FNumericProperty>(Property))
+	{
+		if (!Numeric->IsInteger())
+		{
+			return false;
+		}
+		OutPlan.Kind = EValueKind::Integer;
+	}
+	else if (Property->IsA<FBoolProperty>())
+	{
+		OutPlan.Kind = EValueKind::Bool;
+	}
+	else if (Property->IsA<FStrProperty>())
+	{
+		OutPlan.Kind = EValueKind::String;
+	}
+	else if (Property->IsA<FNameProperty>())
+	{
+		OutPlan.Kind = EValueKind::Name;
+	}
+	else if (const FStructProperty* StructProperty = CastField<FStructProperty>(Property))
+	{
+		OutPlan.Kind = EValueKind::Struct;
+		OutPlan.StructPlan = &FindOrBuild(StructProperty->Struct);
+	}
+	else if (const FArrayProperty* ArrayProperty = CastField<FArrayProperty>(Property))
+	{
+		OutPlan.Kind = EValueKind::Array;
+		OutPlan.Inner = MakeUnique<FValuePlan>();
+		return BuildValuePlan(ArrayProperty->Inner, *OutPlan.Inner);
+	}
+	else
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void FBPSerializationPlan::Write(FBPJsonWriter& Writer, const void* Data) const
+{
+	Writer.BeginObject();
+	for (const FFieldPlan& Field : Fields)
+	{
+		Writer.WriteKey(Field.Key.GetData());
+		WriteValue(Writer, Field.Value, (const uint8*)Data + Field.Offset);
+	}
+	Writer.EndObject();
+}
+
+bool FBPSerializationPlan::Read(FBPJsonReader& Reader, void* Data) const
+{
+	//Anything else is stepped over so the reader can carry on after it, but there is no message in it.
+	if (!Reader.ReadBeginObject())
+	{
+		Reader.SkipValue();
+		return false;
+	}
+
+	int32 Hint = 0;
+	FAnsiStringView Key;
+	while (Reader.NextKey(Key))
+	{
+		const FFieldPlan* Field = FindField(Key, Hint);
+		if (Field == nullptr)
+		{
+			Reader.SkipValue();
+			continue;
+		}
+		//A null leaves the field at its default. ReadNull has already consumed it, so there is nothing left to skip.
+		if (Reader.ReadNull())
+		{
+			continue;
+		}
+		ReadValue(Reader, Field->Value, (uint8*)Data + Field->Offset);
+	}
+
+	return !Reader.HasError();
+}
+
+const FBPSerializationPlan::FFieldPlan* FBPSerializationPlan::FindField(FAnsiStringView Key, int32& InOutHint) const
+{
+	//Intiface sends fields in declaration order, so starting from the field after the last match almost always hits first time.
+	for (int32 i = 0; i < Fields.Num(); i++)
+	{
+		const int32 Index = (InOutHint + i) % Fields.Num();
+		const FFieldPlan& Field = Fields[Index];
+		//Case-insensitive, same leniency FJsonObjectConverter gave us.
+		if (Field.Key.Num() - 1 == Key.Len() && FCStringAnsi::Strnicmp(Field.Key.GetData(), Key.GetData(), Key.Len()) == 0)
+		{
+			InOutHint = Index + 1;
+			return &Field;
+		}
+	}
+	return nullptr;
+}
+
+void FBPSerializationPlan::WriteValue(FBPJsonWriter& Writer, const FValuePlan& Plan, const void* ValuePtr)
+{
+	switch (Plan.Kind)
+	{
+	//Numbers pass their address along in case the writer is building a packet template and wants them in a patch slot.
+	case EValueKind::Int32:
+		Writer.WriteInt(*(const int32*)ValuePtr, ValuePtr);
+		break;
+	case EValueKind::Double:
+		Writer.WriteDouble(*(const double*)ValuePtr, ValuePtr);
+		break;
+	case EValueKind::Float:
+		Writer.WriteDouble(*(const float*)ValuePtr, ValuePtr);
+		break;
+	case EValueKind::Integer:
+		Writer.WriteInt(static_cast<const FNumericProperty*>(Plan.Property)->GetSignedIntPropertyValue(ValuePtr));
+		break;
+	case EValueKind::Enum:
+		Writer.WriteInt(static_cast<const FEnumProperty*>(Plan.Property)->GetUnderlyingProperty()->GetSignedIntPropertyValue(ValuePtr));
+		break;
+	case EValueKind::Bool:
+		Writer.WriteBool(static_cast<const FBoolProperty*>(Plan.Property)->GetPropertyValue(ValuePtr));
+		break;
+	case EValueKind::String:
+		Writer.WriteString(*(const FString*)ValuePtr);
+		break;
+	case EValueKind::Name:
+	{
+		TStringBuilder<FName::StringBufferSize> Name;
+		((const FName*)ValuePtr)->AppendString(Name);
+		Writer.WriteString(Name.ToView());
+		break;
+	}
+	case EValueKind::Struct:
+		Plan.StructPlan->Write(Writer, ValuePtr);
+		break;
+	case EValueKind::Array:
+	{
+		FScriptArrayHelper Helper(static_cast<const FArrayProperty*>(Plan.Property), ValuePtr);
+		Writer.BeginArray();
+		for (int32 i = 0; i < Helper.Num(); i++)
+		{
+			WriteValue(Writer, *Plan.Inner, Helper.GetRawPtr(i));
+		}
+		Writer.EndArray();
+		break;
+	}
+	}
+}
+
+void FBPSerializationPlan::ReadValue(FBPJsonReader& Reader, const FValuePlan& Plan, void* ValuePtr)
+{
+	//Any value of the wrong type is skipped, leaving the field at its default.
+	bool bRead = false;
+	switch (Plan.Kind)
+	{
+	case EValueKind::Int32:
+	{
+		int64 Number;
+		if ((bRead = Reader.ReadInt(Number)))
+		{
+			*(int32*)ValuePtr = (int32)FMath::Clamp<int64>(Number, MIN_int32, MAX_int32);
+		}
+		break;
+	}
+	case EValueKind::Double:
+		bRead = Reader.ReadNumber(*(double*)ValuePtr);
+		break;
+	case EValueKind::Float:
+	{
+		double Number;
+		if ((bRead = Reader.ReadNumber(Number)))
+		{
+			*(float*)ValuePtr = (float)Number;
+		}
+		break;
+	}
+	case EValueKind::Integer:
+	{
+		int64 Number;
+		if ((bRead = Reader.ReadInt(Number)))
+		{
+			static_cast<const FNumericProperty*>(Plan.Property)->SetIntPropertyValue(ValuePtr, Number);
+		}
+		break;
+	}
+	case EValueKind::Enum:
+	{
+		int64 Number;
+		if ((bRead = Reader.ReadInt(Number)))
+		{
+			static_cast<const FEnumProperty*>(Plan.Property)->GetUnderlyingProperty()->SetIntPropertyValue(ValuePtr, Number);
+		}
+		break;
+	}
+	case EValueKind::Bool:
+	{
+		bool bBool;
+		if ((bRead = Reader.ReadBool(bBool)))
+		{
+			static_cast<const FBoolProperty*>(Plan.Property)->SetPropertyValue(ValuePtr, bBool);
+		}
+		break;
+	}
+	case EValueKind::String:
+		bRead = Reader.ReadString(*(FString*)ValuePtr);
+		break;
+	case EValueKind::Name:
+	{
+		FString String;
+		if ((bRead = Reader.ReadString(String)))
+		{
+			*(FName*)ValuePtr = ReadName(String);
+		}
+		break;
+	}
+	case EValueKind::Struct:
+		if (Reader.PeekType() == FBPJsonReader::EValueType::Object)
+		{
+			Plan.StructPlan->Read(Reader, ValuePtr);
+			bRead = true;
+		}
+		break;
+	case EValueKind::Array:
+		if (Reader.ReadBeginArray())
+		{
+			FScriptArrayHelper Helper(static_cast<const FArrayProperty*>(Plan.Property), ValuePtr);
+			Helper.EmptyValues();
+			while (Reader.NextElement())
+			{
+				if (!Reader.CheckArrayLength(Helper.Num()))
+				{
+					break;
+				}
+				const int32 Index = Helper.AddValue();
+				ReadValue(Reader, *Plan.Inner, Helper.GetRawPtr(Index));
+			}
+			bRead = true;
+		}
+		break;
+	}
+
+	if (!bRead)
+	{
+		Reader.SkipValue();
+	}
+}
+
+FName FBPSerializationPlan::ReadName(const FString& String)
+{
+	//FNAME_Find never adds to the name table, the known names are always there once they have been built.
+	GetKnownNames();
+	const FName Existing(*String, FNAME_Find);
+	if (!Existing.IsNone() || String.IsEmpty())
+	{
+		return Existing;
+	}
+
+	if (String.Len() < NAME_SIZE && NewNameCount.load(std::memory_order_relaxed) < MaxNewNames
+		&& NewNameCount.fetch_add(1, std::memory_order_relaxed) < MaxNewNames)
+	{
+		return FName(*String);
+	}
+	RefusedNameCount.fetch_add(1, std::memory_order_relaxed);
+	INC_DWORD_STAT(STAT_BPRefusedNames);
+	return NAME_None;
+}
@@ -0,0 +1,166 @@
+// Copyright d/Dev 2026
+
+#include "BPShadowState.h"
+
+#include "BPMessageRegistry.h"
+
+namespace
+{
+	//The value an actuator is being set to, and anything else that changes what it does.
+	double GetValue(const FBPScalarObject& Element) { return Element.Scalar; }
+	double GetValue(const FBPLinearObject& Element) { return Element.Position; }
+	double GetValue(const FBPRotateObject& Element) { return Element.Speed; }
+
+	double GetExtra(const FBPScalarObject& Element) { return 0.0; }
+	double GetExtra(const FBPLinearObject& Element) { return Element.Duration; }
+	double GetExtra(const FBPRotateObject& Element) { return Element.Clockwise ? 1.0 : 0.0; }
+}
+
+uint64 FBPShadowState::MakeKey(int32 DeviceIndex, EBPMessageType Type, int32 ActuatorIndex)
+{
+	return ((uint64)(uint32)DeviceIndex << 32) | ((uint64)(uint8)Type << 24) | ((uint32)ActuatorIndex & 0xFFFFFF);
+}
+
+template<typename CommandType, typename ElementType>
+bool FBPShadowState::Matches(const CommandType& Command, const ElementType& Element, double Now) const
+{
+	const FActuatorState* State = Actuators.Find(MakeKey(Command.DeviceIndex, FBPMessageRegistry::GetInfo<CommandType>().Type, Element.Index));
+	return State != nullptr
+		&& State->Value == GetValue(Element)
+		&& State->Extra == GetExtra(Element)
+		&& (State->bConfirmed || Now - State->SentAt < UnconfirmedTimeout)
+		&& (RefreshSeconds <= 0.0 || Now - State->SentAt < RefreshSeconds);
+}
+
+template<typename CommandType, typename ElementType>
+bool FBPShadowState::RemoveRedundantImpl(CommandType& Command, TArray<ElementType> CommandType::*Elements) const
+{
+	const double Now = FPlatformTime::Seconds();
+	TArray<ElementType>& Values = Command.*Elements;
+	Values.RemoveAll([this, &Command, Now](const ElementType& Element) { return Matches(Command, Element, Now); });
+	return Values.Num() > 0;
+}
+
+template<typename CommandType, typename ElementType>
+bool FBPShadowState::IsRedundantImpl(const CommandType& Command, TArray<ElementType> CommandType::*Elements) const
+{
+	const double Now = FPlatformTime::Seconds();
+	for (const ElementType& Element : Command.*Elements)
+	{
+		if (!Matches(Command, Element, Now))
+		{
+			return false;
+		}
+	}
+	return (Command.*Elements).Num() > 0;
+}
+
+template<typename CommandType, typename ElementType>
+void FBPShadowState::RecordSentImpl(const CommandType& Command, TArray<ElementType> CommandType::*Elements, int32 Id)
+{
+	const double Now = FPlatformTime::Seconds();
+	const EBPMessageType Type = FBPMessageRegistry::GetInfo<CommandType>().Type;
+	for (const ElementType& Element : Command.*Elements)
+	{
+		FActuatorState& State = Actuators.FindOrAdd(MakeKey(Command.DeviceIndex, Type, Element.Index));
+		State.Value = GetValue(Element);
+		State.Extra = GetExtra(Element);
+		State.SentAt = Now;
+		State.Id = Id;
+		State.bConfirmed = false;
+	}
+}
+
+bool FBPShadowState::RemoveRedundant(FBPScalarCommand& Command) const
+{
+	return RemoveRedundantImpl(Command, &FBPScalarCommand::Scalars);
+}
+
+bool FBPShadowState::RemoveRedundant(FBPLinearCommand& Command) const
+{
+	return RemoveRedundantImpl(Command, &FBPLinearCommand::Vectors);
+}
+
+bool FBPShadowState::RemoveRedundant(FBPRotateCommand& Command) const
+{
+	return RemoveRedundantImpl(Command, &FBPRotateCommand::Rotations);
+}
+
+bool FBPShadowState::IsRedundant(const FInstancedStruct& Command) const
+{
+	if (const FBPScalarCommand* Scalar = Command.GetPtr<FBPScalarCommand>())
+	{
+		return IsRedundantImpl(*Scalar, &FBPScalarCommand::Scalars);
+	}
+	if (const FBPLinearCommand* Linear = Command.GetPtr<FBPLinearCommand>())
+	{
+		return IsRedundantImpl(*Linear, &FBPLinearCommand::Vectors);
+	}
+	if (const FBPRotateCommand* Rotate = Command.GetPtr<FBPRotateCommand>())
+	{
+		return IsRedundantImpl(*Rotate, &FBPRotateCommand::Rotations);
+	}
+	return false;
+}
+
+void FBPShadowState::RecordSent(const FBPScalarCommand& Command, int32 Id)
+{
+	RecordSentImpl(Command, &FBPScalarCommand::Scalars, Id);
+}
+
+void FBPShadowState::RecordSent(const FBPLinearCommand& Command, int32 Id)
+{
+	RecordSentImpl(Command, &FBPLinearCommand::Vectors, Id);
+}
+
+void FBPShadowState::RecordSent(const FBPRotateCommand& Command, int32 Id)
+{
+	RecordSentImpl(Command, &FBPRotateCommand::Rotations, Id);
+}
+
+void FBPShadowState::RecordSent(const FInstancedStruct& Command, int32 Id)
+{
+	if (const FBPScalarCommand* Scalar = Command.GetPtr<FBPScalarCommand>())
+	{
+		RecordSent(*Scalar, Id);
+	}
+	else if (const FBPLinearCommand* Linear = Command.GetPtr<FBPLinearCommand>())
+	{
+		RecordSent(*Linear, Id);
+	}
+	else if (const FBPRotateCommand* Rotate = Command.GetPtr<FBPRotateCommand>())
+	{
+		RecordSent(*Rotate, Id);
+	}
+}
+
+void FBPShadowState::OnReply(int32 Id, bool bSucceeded)
+{
+	for (auto It = Actuators.CreateIterator(); It; ++It)
+	{
+		if (It->Value.Id != Id)
+		{
+			continue;
+		}
+		if (bSucceeded)
+		{
+			It->Value.bConfirmed = true;
+		}
+		else
+		{
+			//We no longer know what the device is doing, so the next value has to be sent.
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void FBPShadowState::RemoveDevice(int32 DeviceIndex)
+{
+	for (auto It = Actuators.CreateIterator(); It; ++It)
+	{
+		if ((int32)(It->Key >> 32) == DeviceIndex)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
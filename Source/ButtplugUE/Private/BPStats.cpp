@@ -0,0 +1,20 @@
+// Copyright d/Dev 2026
+
+#include "BPStats.h"
+
+DEFINE_STAT(STAT_BPSerializeOutbound);
+DEFINE_STAT(STAT_BPOutboundMessages);
+DEFINE_STAT(STAT_BPOutboundBytes);
+DEFINE_STAT(STAT_BPOutboundPackets);
+DEFINE_STAT(STAT_BPCoalescedCommands);
+DEFINE_STAT(STAT_BPSuppressedCommands);
+DEFINE_STAT(STAT_BPRateLimitedCommands);
+DEFINE_STAT(STAT_BPDeserializeInbound);
+DEFINE_STAT(STAT_BPInboundMessages);
+DEFINE_STAT(STAT_BPInboundBytes);
+DEFINE_STAT(STAT_BPUnknownMessages);
+DEFINE_STAT(STAT_BPRefusedNames);
+DEFINE_STAT(STAT_BPSkippedMessages);
+DEFINE_STAT(STAT_BPRejectedPackets);
+DEFINE_STAT(STAT_BPQueryCacheHits);
+DEFINE_STAT(STAT_BPQueryShared);
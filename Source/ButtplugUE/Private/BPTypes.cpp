@@ -2,65 +2,176 @@
 
 #include "BPTypes.h"
 #include "BPLogging.h"
+#include "BPJsonReader.h"
+#include "BPSerializationPlan.h"
+#include "BPMessageRegistry.h"
+#include "BPStats.h"
+#include "ButtplugUESettings.h"
 
-#include "Serialization/JsonSerializer.h"
-#include "Serialization/JsonReader.h"
-#include "Dom/JsonObject.h"
+namespace
+{
+	EBPInboundRejectReason ToRejectReason(FBPJsonReader::EError Error)
+	{
+		switch (Error)
+		{
+		case FBPJsonReader::EError::None: return EBPInboundRejectReason::None;
+		case FBPJsonReader::EError::TooDeep: return EBPInboundRejectReason::TooDeep;
+		case FBPJsonReader::EError::TooLong: return EBPInboundRejectReason::TooLong;
+		default: return EBPInboundRejectReason::Malformed;
+		}
+	}
+
+	//Finds the Id of the message body the reader is sitting on, without consuming anything (the reader is a copy).
+	//Intiface always sends Id first, so this normally stops at the first key.
+	int32 PeekMessageId(FBPJsonReader Reader)
+	{
+		if (!Reader.ReadBeginObject())
+		{
+			return 0;
+		}
+
+		FAnsiStringView Key;
+		while (Reader.NextKey(Key))
+		{
+			int64 Id;
+			if (Key.Len() == 2 && FCStringAnsi::Strnicmp(Key.GetData(), "Id", 2) == 0 && Reader.ReadInt(Id))
+			{
+				return (int32)Id;
+			}
+			Reader.SkipValue();
+		}
+		return 0;
+	}
+}
 
 TArray<FInstancedStruct> UBPTypes::DeserializeMessage(const TOptional<UObject*> Context, const FString& Message)
 {
+	FTCHARToUTF8 Converted(*Message, Message.Len());
+	TArray<FBPDecodedMessage> Decoded;
+	DeserializeMessage(Context, TConstArrayView<uint8>((const uint8*)Converted.Get(), Converted.Length()), Decoded);
+
 	TArray<FInstancedStruct> Out;
-	FString CleanedMessage = "{\"Messages\": " + Message + "}"; //wrap it to make it an array of messages
-	TSharedPtr<FJsonObject> JsonObject = MakeShareable(new FJsonObject());
-	TSharedRef<TJsonReader<TCHAR>> JsonReader = TJsonReaderFactory<TCHAR>::Create(*CleanedMessage);
-	FJsonSerializer::Deserialize(JsonReader, JsonObject);
-	TArray<TSharedPtr<FJsonValue>> Messages = JsonObject->GetArrayField(TEXT("Messages")); //get the array of messages
+	Out.Reserve(Decoded.Num());
+	for (FBPDecodedMessage& Msg : Decoded)
+	{
+		Out.Add(MoveTemp(Msg.Message));
+	}
+	return Out;
+}
+
+void UBPTypes::DeserializeMessage(const TOptional<UObject*> Context, TConstArrayView<uint8> Message, TArray<FBPDecodedMessage>& OutMessages)
+{
+	int32 Skipped = 0;
+	DeserializeMessage(Context, Message, OutMessages, [](EBPMessageType, int32) { return true; }, Skipped);
+}
+
+EBPInboundRejectReason UBPTypes::DeserializeMessage(const TOptional<UObject*> Context, TConstArrayView<uint8> Message, TArray<FBPDecodedMessage>& OutMessages,
+									TFunctionRef<bool(EBPMessageType Type, int32 Id)> ShouldDecode, int32& OutSkipped)
+{
+	SCOPE_CYCLE_COUNTER(STAT_BPDeserializeInbound);
+	INC_DWORD_STAT_BY(STAT_BPInboundBytes, Message.Num());
 
-	for(const TSharedPtr<FJsonValue>& Msg : Messages)
+	const int32 StartNum = OutMessages.Num();
+	OutSkipped = 0;
+
+	//Checked before touching a single byte, so an oversized packet costs nothing to reject.
+	if (Message.Num() > UButtplugUESettings::GetMaxInboundPacketBytes())
 	{
-		TSharedPtr<FJsonObject>* Object;
-		if (Msg->TryGetObject(Object))
+		FStringFormatNamedArguments Args;
+		Args.Add("Size", Message.Num());
+		Args.Add("Max", UButtplugUESettings::GetMaxInboundPacketBytes());
+		BPLog::Error(Context, "Received packet of {Size} bytes, over the limit of {Max}, ignoring it.", Args);
+		return EBPInboundRejectReason::TooLarge;
+	}
+
+	FBPJsonReader::FLimits Limits;
+	Limits.MaxDepth = UButtplugUESettings::GetMaxInboundDepth();
+	Limits.MaxArrayLength = UButtplugUESettings::GetMaxInboundArrayLength();
+	FBPJsonReader Reader(Message, Limits);
+
+	//Intiface always sends an array of messages, each an object of {"Title": {Body}}
+	if (!Reader.ReadBeginArray())
+	{
+		BPLog::Error(Context, "Received message is not a JSON array, ignoring it.");
+		return EBPInboundRejectReason::Malformed;
+	}
+
+	int32 NumElements = 0;
+	while (Reader.NextElement() && Reader.CheckArrayLength(NumElements++))
+	{
+		if (!Reader.ReadBeginObject())
+		{
+			Reader.SkipValue();
+			continue;
+		}
+
+		FAnsiStringView Title;
+		while (Reader.NextKey(Title)) //loop through each message
 		{
-			for (const TPair<FString, TSharedPtr<FJsonValue>>& Field : Object->Get()->Values) //loop through each message
+			const FBPMessageTypeInfo* Info = FBPMessageRegistry::Get().FindByTitle(Title);//get the struct type from the name of the message
+			if (Info == nullptr)
+			{
+				Reader.SkipValue();
+				continue;
+			}
+			if (!ShouldDecode(Info->Type, PeekMessageId(Reader)))
 			{
-				UScriptStruct* StructType = UBPTypes::GetStructType(Field.Key);//get the struct type from the name of the message
-				FInstancedStruct Struct = FInstancedStruct(StructType);
-				FJsonObjectConverter::JsonObjectToUStruct(Object->Get()->GetObjectField(Field.Key).ToSharedRef(), StructType, Struct.GetMutableMemory());//deserialize it
-				Out.Add(Struct);
+				Reader.SkipValue();//nobody is listening, so don't pay for decoding it
+				OutSkipped++;
+				continue;
+			}
+			FBPDecodedMessage& Decoded = OutMessages.AddDefaulted_GetRef();
+			Decoded.Type = Info->Type;
+			Decoded.Message.InitializeAs(Info->Struct);
+			if (!Info->Plan->Read(Reader, Decoded.Message.GetMutableMemory()))//deserialize it straight into place
+			{
+				OutMessages.Pop();//only got part way through, so don't hand out a half-filled message
 			}
 		}
 	}
 
-	return Out;
+	const EBPInboundRejectReason Reason = ToRejectReason(Reader.GetError());
+	if (Reason != EBPInboundRejectReason::None)
+	{
+		FStringFormatNamedArguments Args;
+		Args.Add("Offset", Reader.GetOffset());
+		Args.Add("Reason", UEnum::GetDisplayValueAsText(Reason).ToString());
+		BPLog::Error(Context, "Rejected packet from server at byte {Offset} ({Reason}), ignoring the rest of it.", Args);
+	}
+
+	INC_DWORD_STAT_BY(STAT_BPInboundMessages, OutMessages.Num() - StartNum);
+	INC_DWORD_STAT_BY(STAT_BPSkippedMessages, OutSkipped);
+	return Reason;
+}
+
+void FBPMessagePacket::Serialize(TArray<uint8>& OutBuffer) const
+{
+	const FBPMessageRegistry& Registry = FBPMessageRegistry::Get();
+	FBPJsonWriter Writer(OutBuffer);
+	Writer.BeginArray();
+	for (const FInstancedStruct& Message : Messages)
+	{
+		if (const FBPMessageTypeInfo* Info = Registry.FindByStruct(Message.GetScriptStruct()))
+		{
+			FBPMessageRegistry::WriteMessage(Writer, *Info, Message.GetMemory());
+		}
+	}
+	Writer.EndArray();
 }
 
 UScriptStruct* UBPTypes::GetStructType(const FString& Name)
 {
-	const TMap<FString, UScriptStruct*> Types = {
-		{"Ok",FBPMessageStatusOk::StaticStruct()},
-		{"Error",FBPMessageStatusError::StaticStruct()},
-		{"Ping",FBPMessageStatusPing::StaticStruct()},
-		{"RequestServerInfo",FBPMessageRequestServerInfo::StaticStruct()},
-		{"ServerInfo",FBPMessageServerInfo::StaticStruct()},
-		{"StartScanning",FBPStartScanning::StaticStruct()},
-		{"StopScanning",FBPStopScanning::StaticStruct()},
-		{"ScanningFinished",FBPScanningFinished::StaticStruct()},
-		{"RequestDeviceList",FBPRequestDeviceList::StaticStruct()},
-		{"DeviceList",FBPDeviceList::StaticStruct()},
-		{"DeviceAdded",FBPDeviceAdded::StaticStruct()},
-		{"DeviceRemoved",FBPDeviceRemove::StaticStruct()},
-		{"StopDeviceCmd",FBPStopDeviceCmd::StaticStruct()},
-		{"StopAllDevices",FBPStopAllDevices::StaticStruct()},
-		{"ScalarCmd",FBPScalarCommand::StaticStruct()},
-		{"LinearCmd",FBPLinearCommand::StaticStruct()},
-		{"RotateCmd",FBPRotateCommand::StaticStruct()},
-		{"SensorMessageBase",FBPSensorMessageBase::StaticStruct()},
-		{"SensorReadCmd",FBPSensorReadCommand::StaticStruct()},
-		{"SensorReading",FBPSensorReading::StaticStruct()},
-		{"SensorSubscribeCmd",FBPSensorSubscribeCommand::StaticStruct()},
-		{"SensorUnsubscribeCmd",FBPSensorUnsubscribeCommand::StaticStruct()}
-	};
-
-	check(Types.Contains(Name));
-	return *Types.Find(Name);
+	FTCHARToUTF8 Title(*Name, Name.Len());
+	const FBPMessageTypeInfo* Info = FBPMessageRegistry::Get().FindByTitle(FAnsiStringView(Title.Get(), Title.Length()));
+	return Info != nullptr ? Info->Struct : nullptr;
+}
+
+double UBPTypes::QuantizeActuatorValue(double Value, int32 StepCount)
+{
+	const double Clamped = FMath::IsFinite(Value) ? FMath::Clamp(Value, 0.0, 1.0) : 0.0;
+	if (StepCount <= 0)
+	{
+		return Clamped;
+	}
+	return FMath::RoundToDouble(Clamped * StepCount) / StepCount;
 }
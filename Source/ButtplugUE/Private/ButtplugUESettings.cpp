@@ -14,6 +14,87 @@ EBPLogVerbosity UButtplugUESettings::GetLoggingVerbosity()
 	return GetMutableDefault<UButtplugUESettings>()->LoggingVerbosity;
 }
 
+int32 UButtplugUESettings::GetMaxInboundPacketBytes()
+{
+	return GetMutableDefault<UButtplugUESettings>()->MaxInboundPacketBytes;
+}
+
+int32 UButtplugUESettings::GetMaxInboundArrayLength()
+{
+	return GetMutableDefault<UButtplugUESettings>()->MaxInboundArrayLength;
+}
+
+int32 UButtplugUESettings::GetMaxInboundDepth()
+{
+	return GetMutableDefault<UButtplugUESettings>()->MaxInboundDepth;
+}
+
+int32 UButtplugUESettings::GetMaxInboundMessagesPerFrame()
+{
+	return GetMutableDefault<UButtplugUESettings>()->MaxInboundMessagesPerFrame;
+}
+
+float UButtplugUESettings::GetResponseTimeoutSeconds()
+{
+	return GetMutableDefault<UButtplugUESettings>()->ResponseTimeoutSeconds;
+}
+
+EBPOutboundFlushMode UButtplugUESettings::GetOutboundFlushMode()
+{
+	return GetMutableDefault<UButtplugUESettings>()->OutboundFlushMode;
+}
+
+int32 UButtplugUESettings::GetMaxOutboundPacketBytes()
+{
+	return GetMutableDefault<UButtplugUESettings>()->MaxOutboundPacketBytes;
+}
+
+bool UButtplugUESettings::GetCoalesceCommands()
+{
+	return GetMutableDefault<UButtplugUESettings>()->bCoalesceCommands;
+}
+
+bool UButtplugUESettings::GetSuppressRedundantCommands()
+{
+	return GetMutableDefault<UButtplugUESettings>()->bSuppressRedundantCommands;
+}
+
+float UButtplugUESettings::GetRedundantCommandRefreshSeconds()
+{
+	return GetMutableDefault<UButtplugUESettings>()->RedundantCommandRefreshSeconds;
+}
+
+bool UButtplugUESettings::GetRateLimitDevices()
+{
+	return GetMutableDefault<UButtplugUESettings>()->bRateLimitDevices;
+}
+
+int32 UButtplugUESettings::GetMaxUnackedCommands()
+{
+	return GetMutableDefault<UButtplugUESettings>()->MaxUnackedCommands;
+}
+
+float UButtplugUESettings::GetCommandLatencyTargetSeconds()
+{
+	return GetMutableDefault<UButtplugUESettings>()->CommandLatencyTargetSeconds;
+}
+
+float UButtplugUESettings::GetQueryCacheSeconds(EBPMessageType QueryType)
+{
+	const UButtplugUESettings* Settings = GetDefault<UButtplugUESettings>();
+	switch (QueryType)
+	{
+	case EBPMessageType::RequestDeviceList:
+		return Settings->DeviceListCacheSeconds;
+	case EBPMessageType::RequestServerInfo:
+		return Settings->ServerInfoCacheSeconds;
+	case EBPMessageType::SensorReadCmd:
+		return Settings->SensorReadCacheSeconds;
+	default:
+		return 0.0f;
+	}
+}
+
 FString UButtplugUESettings::GetButtplugServer()
 {
 	return GetMutableDefault<UButtplugUESettings>()->Server;
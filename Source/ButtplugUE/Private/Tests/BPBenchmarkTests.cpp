@@ -0,0 +1,232 @@
+// Copyright d/Dev 2026
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "BPOutboundQueue.h"
+#include "BPMessageRegistry.h"
+#include "BPTypes.h"
+#include "BPTestAllocationCounter.h"
+#include "Serialization/JsonSerializer.h"
+#include "JsonObjectConverter.h"
+
+/*Benchmarks for the serialization paths. They report numbers rather than check them, run them with the Perf filter
+and compare against the legacy paths they replaced, which are kept here as they were for that purpose.*/
+
+namespace
+{
+	struct FBenchmarkResult
+	{
+		double NanosecondsPerOp = 0.0;
+		double AllocationsPerOp = 0.0;
+	};
+
+	//Times Iterations runs of Op on this thread, after a warm up pass, counting the allocations it makes along the way.
+	template<typename OpType>
+	FBenchmarkResult RunBenchmark(int32 Iterations, OpType&& Op)
+	{
+		for (int32 i = 0; i < FMath::Min(Iterations, 100); i++)
+		{
+			Op(i);
+		}
+
+		FBPAllocationCounter::Start();
+		const double Start = FPlatformTime::Seconds();
+		for (int32 i = 0; i < Iterations; i++)
+		{
+			Op(i);
+		}
+		const double Seconds = FPlatformTime::Seconds() - Start;
+		const uint64 Allocations = FBPAllocationCounter::Stop();
+
+		return { Seconds * 1e9 / Iterations, (double)Allocations / Iterations };
+	}
+
+	//The FString::Format based ToString chain a ScalarCmd went through before FBPJsonWriter, as it was.
+	FString LegacyScalarObjectToString(const FBPScalarObject& Scalar, const FString& ActuatorType)
+	{
+		FStringFormatNamedArguments Args;
+		Args.Add(TEXT("Index"), Scalar.Index);
+		Args.Add(TEXT("Scalar"), Scalar.Scalar);
+		Args.Add(TEXT("ActuatorType"), ActuatorType);
+		return FString::Format(TEXT("{\"Index\": {Index}, \"Scalar\": {Scalar}, \"ActuatorType\": \"{ActuatorType}\"}"), Args);
+	}
+
+	FString LegacyScalarCommandToString(const FBPScalarCommand& Command, const FString& ActuatorType)
+	{
+		FStringFormatNamedArguments Args;
+		Args.Add(TEXT("Id"), Command.Id);
+		Args.Add(TEXT("DeviceIndex"), Command.DeviceIndex);
+
+		FString ScalarsString = "[";
+		for (int i = 0; i < Command.Scalars.Num(); i++)
+		{
+			ScalarsString += LegacyScalarObjectToString(Command.Scalars[i], ActuatorType);
+			if (i != Command.Scalars.Num() - 1)
+			{
+				ScalarsString += ",";
+			}
+		}
+		ScalarsString += "]";
+
+		Args.Add(TEXT("Scalars"), ScalarsString);
+
+		return FString::Format(TEXT("{\"Id\": {Id}, \"DeviceIndex\": {DeviceIndex}, \"Scalars\": {Scalars}}"), Args);
+	}
+
+	FString LegacyPacketToString(const FBPScalarCommand& Command, const FString& ActuatorType)
+	{
+		FString Out = "[";
+		Out += "{\"";
+		Out += FBPScalarCommand::MessageTitle;
+		Out += "\":";
+		Out += LegacyScalarCommandToString(Command, ActuatorType);
+		Out += "}";
+		Out += "]";
+		return Out;
+	}
+
+	//The FJsonObject DOM path DeserializeMessage took before FBPJsonReader, as it was.
+	TArray<FInstancedStruct> LegacyDeserializeMessage(const FString& Message)
+	{
+		TArray<FInstancedStruct> Out;
+		FString CleanedMessage = "{\"Messages\": " + Message + "}";
+		TSharedPtr<FJsonObject> JsonObject = MakeShareable(new FJsonObject());
+		TSharedRef<TJsonReader<TCHAR>> JsonReader = TJsonReaderFactory<TCHAR>::Create(*CleanedMessage);
+		FJsonSerializer::Deserialize(JsonReader, JsonObject);
+		TArray<TSharedPtr<FJsonValue>> Messages = JsonObject->GetArrayField(TEXT("Messages"));
+
+		for (const TSharedPtr<FJsonValue>& Msg : Messages)
+		{
+			TSharedPtr<FJsonObject>* Object;
+			if (Msg->TryGetObject(Object))
+			{
+				for (const TPair<FString, TSharedPtr<FJsonValue>>& Field : Object->Get()->Values)
+				{
+					UScriptStruct* StructType = UBPTypes::GetStructType(Field.Key);
+					FInstancedStruct Struct = FInstancedStruct(StructType);
+					FJsonObjectConverter::JsonObjectToUStruct(Object->Get()->GetObjectField(Field.Key).ToSharedRef(), StructType, Struct.GetMutableMemory());
+					Out.Add(Struct);
+				}
+			}
+		}
+
+		return Out;
+	}
+
+	//Times both inbound paths over one packet and reports their throughput.
+	void BenchmarkDeserialize(FAutomationTestBase& Test, const TCHAR* Name, const FBPOutboundPacket& Packet, int32 Iterations)
+	{
+		const FString PacketString = FString(FUTF8ToTCHAR((const ANSICHAR*)Packet.Bytes.GetData(), Packet.Bytes.Num()));
+
+		int32 LegacyDecoded = 0;
+		const FBenchmarkResult Legacy = RunBenchmark(Iterations, [&](int32)
+			{
+				LegacyDecoded = LegacyDeserializeMessage(PacketString).Num();
+			});
+
+		TArray<FBPDecodedMessage> Decoded;
+		const FBenchmarkResult Current = RunBenchmark(Iterations, [&](int32)
+			{
+				Decoded.Reset();
+				UBPTypes::DeserializeMessage(TOptional<UObject*>(), Packet.Bytes, Decoded);
+			});
+
+		Test.TestEqual(FString::Printf(TEXT("%s: both paths decode every message"), Name), Decoded.Num(), LegacyDecoded);
+
+		auto Report = [&](const TCHAR* Path, const FBenchmarkResult& Result)
+		{
+			const double Seconds = Result.NanosecondsPerOp * 1e-9;
+			Test.AddInfo(FString::Printf(TEXT("%s (%d messages, %d bytes), %s: %.1f us per packet, %.1f MB/s, %.0f messages/s, %.1f allocations per packet."),
+				Name, Packet.Num(), Packet.Bytes.Num(), Path, Result.NanosecondsPerOp / 1000.0,
+				Packet.Bytes.Num() / Seconds / (1024.0 * 1024.0), Packet.Num() / Seconds, Result.AllocationsPerOp));
+		};
+		Report(TEXT("legacy FJsonObject"), Legacy);
+		Report(TEXT("FBPJsonReader"), Current);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBPSerializeBenchmark, "ButtplugUE.Benchmark.Serialize",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FBPSerializeBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int32 Iterations = 20000;
+	FBPScalarCommand Command(1, 0, { FBPScalarObject(0, 0.5, "Vibrate"), FBPScalarObject(1, 0.25, "Vibrate") });
+	const FString ActuatorType = TEXT("Vibrate");
+
+	//Before: nested ToString calls, then the TCHAR to UTF-8 conversion IWebSocket::Send(FString) did.
+	int32 LegacyBytes = 0;
+	const FBenchmarkResult Legacy = RunBenchmark(Iterations, [&](int32 i)
+		{
+			Command.Id = i + 1;
+			const FString Packet = LegacyPacketToString(Command, ActuatorType);
+			FTCHARToUTF8 Utf8(*Packet);
+			LegacyBytes = Utf8.Length();
+		});
+
+	//Now: written straight into the outbound queue's UTF-8 buffer, and finished into a reused packet as UBPDeviceSubsystem does.
+	FBPOutboundQueue Queue;
+	FBPOutboundPacket Packet;
+	int32 Bytes = 0;
+	const FBPMessageTypeInfo& Info = FBPMessageRegistry::GetInfo<FBPScalarCommand>();
+	const FBenchmarkResult Current = RunBenchmark(Iterations, [&](int32 i)
+		{
+			Command.Id = i + 1;
+			Queue.Add(Info, &Command, Command.Id, Command.DeviceIndex);
+			Queue.Finish(Packet);
+			Bytes = Packet.Bytes.Num();
+		});
+
+	AddInfo(FString::Printf(TEXT("ScalarCmd, legacy ToString: %.0f ns and %.1f allocations per message."), Legacy.NanosecondsPerOp, Legacy.AllocationsPerOp));
+	AddInfo(FString::Printf(TEXT("ScalarCmd, FBPJsonWriter: %.0f ns and %.1f allocations per message."), Current.NanosecondsPerOp, Current.AllocationsPerOp));
+	AddInfo(FString::Printf(TEXT("Bytes on the wire per message: legacy %d, now %d."), LegacyBytes, Bytes));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBPDeserializeBenchmark, "ButtplugUE.Benchmark.Deserialize",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FBPDeserializeBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int32 Iterations = 500;
+
+	//A large DeviceList, as after scanning with a room full of devices.
+	FBPDeviceList List;
+	List.Id = 1;
+	for (int32 i = 0; i < 32; i++)
+	{
+		FBPDeviceObject& Device = List.Devices.AddDefaulted_GetRef();
+		Device.DeviceName = FString::Printf(TEXT("Test Device %d"), i);
+		Device.DeviceDisplayName = Device.DeviceName;
+		Device.DeviceIndex = i;
+		Device.DeviceMessageTimingGap = 100;
+		Device.DeviceMessages.ScalarCmd.Add(FBPCommandMessage(20, TEXT("Clitoral Stimulator"), "Vibrate"));
+		Device.DeviceMessages.ScalarCmd.Add(FBPCommandMessage(20, TEXT("Insertable Vibrator"), "Vibrate"));
+		Device.DeviceMessages.RotateCmd.Add(FBPCommandMessage(10, TEXT("Rotator"), "Rotate"));
+	}
+	FBPOutboundQueue Queue;
+	FBPOutboundPacket DeviceListPacket;
+	Queue.Add(FBPMessageRegistry::GetInfo<FBPDeviceList>(), &List, List.Id, INDEX_NONE);
+	Queue.Finish(DeviceListPacket);
+	BenchmarkDeserialize(*this, TEXT("DeviceList"), DeviceListPacket, Iterations);
+
+	//A burst of subscribed sensor readings in one packet.
+	FBPOutboundPacket ReadingsPacket;
+	for (int32 i = 0; i < 256; i++)
+	{
+		FBPSensorReading Reading;
+		Reading.Id = 0;
+		Reading.DeviceIndex = i % 8;
+		Reading.SensorIndex = 0;
+		Reading.SensorType = "Pressure";
+		Reading.Data = { 100 + i, 200 + i, 300 + i, 400 + i };
+		Queue.Add(FBPMessageRegistry::GetInfo<FBPSensorReading>(), &Reading, Reading.Id, Reading.DeviceIndex);
+	}
+	Queue.Finish(ReadingsPacket);
+	BenchmarkDeserialize(*this, TEXT("SensorReading"), ReadingsPacket, Iterations);
+	return true;
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
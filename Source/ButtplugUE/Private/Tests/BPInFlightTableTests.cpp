@@ -0,0 +1,70 @@
+// Copyright d/Dev 2026
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "BPInFlightTable.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBPInFlightTableCollisionTest, "ButtplugUE.InFlight.Collisions",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FBPInFlightTableCollisionTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 Capacity = 8;
+	using FTable = TBPInFlightTable<int32, Capacity>;
+	FTable Table;
+	FTable::FEntry Evicted;
+	int32 Payload = 0;
+
+	//One request left waiting while the session goes on: most messages in between are fire-and-forget, so their Ids
+	//are never tracked, and now and then another request lands on the same home slot.
+	TestFalse(TEXT("Add the long-lived request"), Table.Add(1, 1, 100.0, Evicted));
+	int32 Tracked = 1;
+	for (int32 Id = 2; Id <= Capacity * 4 + 1; Id++)
+	{
+		const bool bSameSlot = (Id & (Capacity - 1)) == 1;
+		if (bSameSlot || Id % 5 == 0)
+		{
+			TestFalse(FString::Printf(TEXT("Adding %d evicts nothing"), Id), Table.Add(Id, Id, 100.0 + Id, Evicted));
+			Tracked++;
+			//Answered straight away, except the ones sharing the long-lived request's slot.
+			if (!bSameSlot)
+			{
+				TestTrue(FString::Printf(TEXT("Remove %d"), Id), Table.Remove(Id, Payload) && Payload == Id);
+				Tracked--;
+			}
+		}
+		TestTrue(FString::Printf(TEXT("Long-lived request still waiting after Id %d"), Id), Table.Contains(1));
+	}
+	TestEqual(TEXT("Requests waiting"), Table.Num(), Tracked);
+
+	//Every one that shared its slot is still found, and can be answered out of order.
+	TestTrue(TEXT("Remove 17"), Table.Remove(17, Payload) && Payload == 17);
+	TestTrue(TEXT("Remove 1"), Table.Remove(1, Payload) && Payload == 1);
+	TestFalse(TEXT("1 is gone"), Table.Contains(1));
+	for (int32 Id = 1 + Capacity; Id <= Capacity * 4 + 1; Id += Capacity)
+	{
+		TestEqual(FString::Printf(TEXT("%d still waiting"), Id), Table.Contains(Id), Id != 17);
+	}
+	TestFalse(TEXT("Untracked Ids are not found"), Table.Contains(2) || Table.Contains(Capacity * 4 + 2));
+
+	//Only a full table evicts, and then it is the oldest request.
+	TArray<FTable::FEntry> Pending;
+	Table.Reset(Pending);
+	for (int32 Id = 1; Id <= Capacity; Id++)
+	{
+		Table.Add(Id * Capacity, Id, 100.0 + Id, Evicted);
+	}
+	TestTrue(TEXT("Adding to a full table evicts"), Table.Add(3, 0, 200.0, Evicted));
+	TestEqual(TEXT("The oldest is evicted"), Evicted.Id, Capacity);
+	TestTrue(TEXT("The rest are still waiting"), Table.Contains(Capacity * 2) && Table.Contains(Capacity * Capacity) && Table.Contains(3));
+	TestEqual(TEXT("Table stays at capacity"), Table.Num(), Capacity);
+
+	//Expiry still goes oldest first, wherever they ended up.
+	FTable::FEntry Expired;
+	TestTrue(TEXT("Oldest expires first"), Table.PopExpired(1000.0, Expired) && Expired.Id == Capacity * 2);
+	return true;
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,275 @@
+// Copyright d/Dev 2026
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "BPJsonReader.h"
+#include "BPSerializationPlan.h"
+#include "BPTypes.h"
+#include "Math/RandomStream.h"
+#include "UObject/StructOnScope.h"
+#include "ButtplugUESettings.h"
+
+namespace
+{
+	TConstArrayView<uint8> AsBytes(FAnsiStringView Text)
+	{
+		return TConstArrayView<uint8>((const uint8*)Text.GetData(), Text.Len());
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBPJsonReaderNullFieldTest, "ButtplugUE.Inbound.NullField",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FBPJsonReaderNullFieldTest::RunTest(const FString& Parameters)
+{
+	//A known field set to null, in the middle of the object so the fields after it have to be read too.
+	FBPJsonReader Reader(AsBytes("{\"Id\":1,\"ServerName\":null,\"MessageVersion\":3,\"MaxPingTime\":100}"));
+	FBPMessageServerInfo Info;
+	const bool bRead = FBPSerializationPlan::Get(FBPMessageServerInfo::StaticStruct()).Read(Reader, &Info);
+	TestTrue(TEXT("Read succeeds"), bRead);
+	TestFalse(TEXT("Reader has no error"), Reader.HasError());
+	TestEqual(TEXT("Null field keeps its default"), Info.ServerName, FString(TEXT("None")));
+	TestEqual(TEXT("MessageVersion"), Info.MessageVersion, 3);
+	TestEqual(TEXT("MaxPingTime"), Info.MaxPingTime, 100);
+
+	//And the whole way through, as a packet from the server.
+	TArray<FBPDecodedMessage> Messages;
+	int32 Skipped = 0;
+	const EBPInboundRejectReason Reason = UBPTypes::DeserializeMessage(TOptional<UObject*>(), AsBytes("[{\"ServerInfo\":{\"Id\":1,\"ServerName\":null,\"MessageVersion\":3,\"MaxPingTime\":0}}]"),
+		Messages, [](EBPMessageType, int32) { return true; }, Skipped);
+	TestEqual(TEXT("Packet with a null field is accepted"), Reason, EBPInboundRejectReason::None);
+	TestEqual(TEXT("Messages decoded"), Messages.Num(), 1);
+	if (Messages.Num() == 1 && Messages[0].Message.GetPtr<FBPMessageServerInfo>() != nullptr)
+	{
+		TestEqual(TEXT("Decoded MessageVersion"), Messages[0].Message.Get<FBPMessageServerInfo>().MessageVersion, 3);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBPJsonReaderNonObjectBodyTest, "ButtplugUE.Inbound.NonObjectBody",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FBPJsonReaderNonObjectBodyTest::RunTest(const FString& Parameters)
+{
+	FBPJsonReader Reader(AsBytes("5"));
+	FBPMessageStatusOk Ok;
+	TestFalse(TEXT("A body that is not an object is not read"), FBPSerializationPlan::Get(FBPMessageStatusOk::StaticStruct()).Read(Reader, &Ok));
+
+	//Dropped, and the rest of the packet is still read.
+	TArray<FBPDecodedMessage> Messages;
+	int32 Skipped = 0;
+	const EBPInboundRejectReason Reason = UBPTypes::DeserializeMessage(TOptional<UObject*>(), AsBytes("[{\"Ok\":5},{\"Ok\":[1]},{\"Ok\":{\"Id\":2}}]"),
+		Messages, [](EBPMessageType, int32) { return true; }, Skipped);
+	TestEqual(TEXT("Packet is accepted"), Reason, EBPInboundRejectReason::None);
+	if (TestEqual(TEXT("Only the object body is decoded"), Messages.Num(), 1))
+	{
+		TestEqual(TEXT("Decoded Id"), Messages[0].Message.Get<FBPMessageBase>().GetId(), 2);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBPJsonReaderTypeNameTest, "ButtplugUE.Inbound.TypeNames",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FBPJsonReaderTypeNameTest::RunTest(const FString& Parameters)
+{
+	//Types are Strings, so ones added to the protocol after this plugin still come through as they were sent.
+	FBPJsonReader Reader(AsBytes("{\"Id\":1,\"DeviceIndex\":0,\"Scalars\":[{\"Index\":0,\"Scalar\":0.5,\"ActuatorType\":\"Vibrate\"},{\"Index\":1,\"Scalar\":0.5,\"ActuatorType\":\"NotYetAnActuator\"}]}"));
+	FBPScalarCommand Command;
+	TestTrue(TEXT("Read succeeds"), FBPSerializationPlan::Get(FBPScalarCommand::StaticStruct()).Read(Reader, &Command));
+	if (!TestEqual(TEXT("Scalars"), Command.Scalars.Num(), 2))
+	{
+		return false;
+	}
+
+	TestEqual(TEXT("Known types are read"), Command.Scalars[0].ActuatorType, FString(TEXT("Vibrate")));
+	TestEqual(TEXT("Unknown types are kept"), Command.Scalars[1].ActuatorType, FString(TEXT("NotYetAnActuator")));
+
+	//Name fields the same, within the cap on names new to the name table. The same string every run, so only ever one new name.
+	TestEqual(TEXT("Known names are read"), FBPSerializationPlan::ReadName(TEXT("Vibrate")), FName("Vibrate"));
+	TestEqual(TEXT("New names are kept"), FBPSerializationPlan::ReadName(TEXT("NotYetAnActuator")).ToString(), FString(TEXT("NotYetAnActuator")));
+	TestTrue(TEXT("Empty names read as None"), FBPSerializationPlan::ReadName(FString()).IsNone());
+	return true;
+}
+
+namespace
+{
+	//Valid packets of every shape the server sends, for the fuzzer to start from.
+	const ANSICHAR* const FuzzSeeds[] = {
+		"[{\"Ok\":{\"Id\":1}}]",
+		"[{\"Error\":{\"Id\":0,\"ErrorMessage\":\"Server received invalid JSON.\",\"ErrorCode\":3}}]",
+		"[{\"ServerInfo\":{\"Id\":1,\"ServerName\":\"Intiface Server\",\"MessageVersion\":3,\"MaxPingTime\":100}}]",
+		"[{\"ScanningFinished\":{\"Id\":0}},{\"DeviceRemoved\":{\"Id\":0,\"DeviceIndex\":3}}]",
+		"[{\"DeviceList\":{\"Id\":2,\"Devices\":[{\"DeviceName\":\"Test Vibrator\",\"DeviceIndex\":0,\"DeviceMessageTimingGap\":100,"
+			"\"DeviceMessages\":{\"ScalarCmd\":[{\"StepCount\":20,\"FeatureDescriptor\":\"Clitoral Stimulator\",\"ActuatorType\":\"Vibrate\"},"
+			"{\"StepCount\":20,\"FeatureDescriptor\":\"Insertable Vibrator\",\"ActuatorType\":\"Vibrate\"}],"
+			"\"RotateCmd\":[{\"StepCount\":10,\"FeatureDescriptor\":\"\",\"ActuatorType\":\"Rotate\"}],\"StopDeviceCmd\":{}}}]}}]",
+		"[{\"SensorReading\":{\"Id\":4,\"DeviceIndex\":0,\"SensorIndex\":0,\"SensorType\":\"Pressure\",\"Data\":[591,-1,1e3,0.5]}}]",
+	};
+
+	//Tokens that push the parser down its less travelled paths when spliced in.
+	const ANSICHAR* const FuzzTokens[] = {
+		"{", "}", "[", "]", ",", ":", "\"", "\\", "\\u00e9", "\\ud800", "null", "true", "false", "-", "1e999", "-0.0e-5", "0x10",
+		"\"Id\":", "{\"Ok\":", "\xff", "\xc3", "\xe2\x82", "\t\n ", "\"\\\"\"",
+	};
+
+	void InsertBytes(TArray<uint8>& Data, int32 At, const ANSICHAR* Bytes)
+	{
+		Data.Insert((const uint8*)Bytes, FCStringAnsi::Strlen(Bytes), At);
+	}
+
+	//Damages a valid packet in one of a few ways, sometimes several times over.
+	void Mutate(FRandomStream& Random, TArray<uint8>& Data)
+	{
+		const int32 Mutations = Random.RandRange(1, 4);
+		for (int32 m = 0; m < Mutations; m++)
+		{
+			const int32 At = Data.Num() > 0 ? Random.RandHelper(Data.Num()) : 0;
+			switch (Random.RandHelper(8))
+			{
+			case 0:		//Flip a byte.
+				if (Data.Num() > 0)
+				{
+					Data[At] = (uint8)Random.RandHelper(256);
+				}
+				break;
+			case 1:		//Cut it short.
+				Data.SetNum(At);
+				break;
+			case 2:		//Take a slice out.
+				Data.RemoveAt(At, FMath::Min(Random.RandRange(1, 16), Data.Num() - At));
+				break;
+			case 3:		//Splice in a token.
+				InsertBytes(Data, At, FuzzTokens[Random.RandHelper(UE_ARRAY_COUNT(FuzzTokens))]);
+				break;
+			case 4:		//Repeat a slice, so objects and arrays get duplicated or unbalanced.
+			{
+				const int32 Length = FMath::Min(Random.RandRange(1, 64), Data.Num() - At);
+				const TArray<uint8> Slice(Data.GetData() + At, Length);
+				Data.Insert(Slice, Random.RandHelper(Data.Num() + 1));
+				break;
+			}
+			case 5:		//Bury it deep.
+			{
+				const int32 Depth = Random.RandRange(1, 200);
+				for (int32 i = 0; i < Depth; i++)
+				{
+					InsertBytes(Data, 0, Random.RandBool() ? "[" : "[{\"Ok\":");
+				}
+				break;
+			}
+			case 6:		//A huge array where a value should be.
+			{
+				TArray<uint8> Array;
+				InsertBytes(Array, 0, "[");
+				const int32 Length = Random.RandRange(1, 10000);
+				for (int32 i = 0; i < Length; i++)
+				{
+					InsertBytes(Array, Array.Num(), i > 0 ? ",1" : "1");
+				}
+				InsertBytes(Array, Array.Num(), Random.RandBool() ? "]" : "");
+				Data.Insert(Array, At);
+				break;
+			}
+			default:	//A run of noise.
+			{
+				const int32 Length = Random.RandRange(1, 32);
+				for (int32 i = 0; i < Length; i++)
+				{
+					Data.Insert((uint8)Random.RandHelper(256), At);
+				}
+				break;
+			}
+			}
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBPJsonReaderFuzzTest, "ButtplugUE.Inbound.Fuzz",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FBPJsonReaderFuzzTest::RunTest(const FString& Parameters)
+{
+	//Fixed, so a failure can be reproduced. Pass a number as the test parameter to try another.
+	const int32 Seed = Parameters.IsNumeric() ? FCString::Atoi(*Parameters) : 0x42554A53;
+	constexpr int32 Iterations = 20000;
+	FRandomStream Random(Seed);
+	//Most packets are rejected, and each would otherwise log an error.
+	TGuardValue<EBPLogVerbosity> Quiet(GetMutableDefault<UButtplugUESettings>()->LoggingVerbosity, EBPLogVerbosity::NoLogging);
+
+	const UScriptStruct* Structs[] = {
+		FBPDeviceList::StaticStruct(), FBPSensorReading::StaticStruct(), FBPMessageServerInfo::StaticStruct(), FBPMessageStatusError::StaticStruct()
+	};
+
+	int32 Accepted = 0;
+	int32 Rejected[(int32)EBPInboundRejectReason::MAX] = {};
+	int64 Bytes = 0;
+	TArray<uint8> Data;
+	TArray<FBPDecodedMessage> Messages;
+	const double Start = FPlatformTime::Seconds();
+	for (int32 i = 0; i < Iterations; i++)
+	{
+		Data.Reset();
+		if (i % 10 == 0)
+		{
+			//Now and then, nothing like JSON at all.
+			const int32 Length = Random.RandHelper(512);
+			for (int32 b = 0; b < Length; b++)
+			{
+				Data.Add((uint8)Random.RandHelper(256));
+			}
+		}
+		else
+		{
+			InsertBytes(Data, 0, FuzzSeeds[Random.RandHelper(UE_ARRAY_COUNT(FuzzSeeds))]);
+			Mutate(Random, Data);
+		}
+		Bytes += Data.Num();
+
+		//The whole inbound path, decoding everything or only some of it.
+		Messages.Reset();
+		int32 Skipped = 0;
+		const bool bDecodeAll = Random.RandBool();
+		const EBPInboundRejectReason Reason = UBPTypes::DeserializeMessage(TOptional<UObject*>(), Data, Messages,
+			[bDecodeAll](EBPMessageType, int32 Id) { return bDecodeAll || (Id & 1) == 0; }, Skipped);
+		if (!TestTrue(TEXT("Reject reason is valid"), Reason < EBPInboundRejectReason::MAX))
+		{
+			AddError(FString::Printf(TEXT("Iteration %d of seed %d"), i, Seed));
+			return false;
+		}
+		(Reason == EBPInboundRejectReason::None ? Accepted : Rejected[(int32)Reason])++;
+		//A rejected packet keeps what was decoded before the fault, so everything handed out is checked either way.
+		for (const FBPDecodedMessage& Message : Messages)
+		{
+			if (!TestTrue(TEXT("Decoded messages hold a struct of their type"), Message.Message.IsValid() && Message.Type < EBPMessageType::MAX))
+			{
+				AddError(FString::Printf(TEXT("Iteration %d of seed %d"), i, Seed));
+				return false;
+			}
+		}
+
+		//And a message body on its own, read straight into a struct, past the packet level checks.
+		const UScriptStruct* Struct = Structs[Random.RandHelper(UE_ARRAY_COUNT(Structs))];
+		FStructOnScope Target(Struct);
+		FBPJsonReader Reader(Data, { 16, 4096 });
+		FBPSerializationPlan::Get(Struct).Read(Reader, Target.GetStructMemory());
+		if (!TestTrue(TEXT("Reader stays inside its buffer"), Reader.GetOffset() >= 0 && Reader.GetOffset() <= Data.Num()))
+		{
+			AddError(FString::Printf(TEXT("Iteration %d of seed %d"), i, Seed));
+			return false;
+		}
+	}
+	const double Seconds = FPlatformTime::Seconds() - Start;
+
+	//Mutations that leave a packet valid are rare but do happen, so only report the split.
+	AddInfo(FString::Printf(TEXT("Seed %d: %d packets, %d accepted, rejected %d too large, %d too deep, %d too long, %d malformed."), Seed, Iterations, Accepted,
+		Rejected[(int32)EBPInboundRejectReason::TooLarge], Rejected[(int32)EBPInboundRejectReason::TooDeep],
+		Rejected[(int32)EBPInboundRejectReason::TooLong], Rejected[(int32)EBPInboundRejectReason::Malformed]));
+	AddInfo(FString::Printf(TEXT("%.1f MB/s, %.2f us per packet."), Bytes / Seconds / (1024.0 * 1024.0), Seconds * 1e6 / Iterations));
+	TestTrue(TEXT("Some packets were rejected"), Accepted < Iterations);
+	return true;
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,313 @@
+// Copyright d/Dev 2026
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "BPOutboundThread.h"
+#include "BPOutboundQueue.h"
+#include "BPMessageRegistry.h"
+#include "BPTestWebSocket.h"
+#include "BPTestAllocationCounter.h"
+#include "BPCommandCoalescer.h"
+#include "BPDeviceSubsystem.h"
+#include "Async/Async.h"
+#include "Engine/GameInstance.h"
+#include "UObject/StrongObjectPtr.h"
+
+namespace
+{
+	void AddScalar(FBPOutboundQueue& Queue, int32 Id, int32 DeviceIndex)
+	{
+		FBPScalarCommand Command(Id, DeviceIndex, { FBPScalarObject(0, 0.5, "Vibrate") });
+		Queue.Add(FBPMessageRegistry::GetInfo<FBPScalarCommand>(), &Command, Id, DeviceIndex);
+	}
+
+	FBPOutboundPacket Finish(FBPOutboundQueue& Queue)
+	{
+		FBPOutboundPacket Packet;
+		Queue.Finish(Packet);
+		return Packet;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBPOutboundStopOrderTest, "ButtplugUE.Outbound.StopOrder",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FBPOutboundStopOrderTest::RunTest(const FString& Parameters)
+{
+	if (!FPlatformProcess::SupportsMultithreading())
+	{
+		AddInfo(TEXT("No threads, packets are sent as they are queued so there is no order to check."));
+		return true;
+	}
+
+	TSharedRef<FBPTestWebSocket> Socket = MakeShared<FBPTestWebSocket>();
+	FBPOutboundThread Thread;
+	FBPOutboundQueue Queue;
+	Thread.SetSocket(Socket);
+
+	//Block the thread inside the send of the first packet, so the next ones queue up behind it.
+	Socket->Hold();
+	AddScalar(Queue, 1, 1);
+	Thread.Send(Finish(Queue));
+	TestTrue(TEXT("Thread started sending the first packet"), Socket->WaitForSends(1));
+
+	//Queued before the stop: one for device 1 and 2 plus an unrelated request, and one only for device 1.
+	AddScalar(Queue, 2, 1);
+	AddScalar(Queue, 3, 2);
+	FBPRequestDeviceList List(4);
+	Queue.Add(FBPMessageRegistry::GetInfo<FBPRequestDeviceList>(), &List, 4, INDEX_NONE);
+	Thread.Send(Finish(Queue));
+	AddScalar(Queue, 5, 1);
+	Thread.Send(Finish(Queue));
+
+	FBPStopDeviceCmd Stop(6, 1);
+	Queue.Add(FBPMessageRegistry::GetInfo<FBPStopDeviceCmd>(), &Stop, 6, 1);
+	Thread.SendStop(Finish(Queue), 1);
+
+	//Queued after the stop, so it should start the device again as asked.
+	AddScalar(Queue, 7, 1);
+	Thread.Send(Finish(Queue));
+
+	Socket->Release();
+	TestTrue(TEXT("Everything was sent"), Thread.WaitUntilSent(5.0));
+
+	TArray<TArray<int32>> Wire;
+	for (const TArray<uint8>& Packet : Socket->GetSent())
+	{
+		Wire.Add(BPTest::GetMessageIds(Packet));
+	}
+
+	const TArray<TArray<int32>> Expected = { { 1 }, { 6 }, { 3, 4 }, { 7 } };
+	TestEqual(TEXT("Packets on the wire"), Wire.Num(), Expected.Num());
+	for (int32 i = 0; i < FMath::Min(Wire.Num(), Expected.Num()); i++)
+	{
+		TestEqual(FString::Printf(TEXT("Packet %d"), i), Wire[i], Expected[i]);
+	}
+
+	TArray<int32> Dropped;
+	int32 Id;
+	while (Thread.TakeDroppedId(Id))
+	{
+		Dropped.Add(Id);
+	}
+	TestEqual(TEXT("Commands the stop overtook are reported as dropped"), Dropped, TArray<int32>({ 2, 5 }));
+
+	Thread.Shutdown(1.0);
+	Thread.SetSocket(nullptr);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBPOutboundSocketReleaseTest, "ButtplugUE.Outbound.SocketRelease",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FBPOutboundSocketReleaseTest::RunTest(const FString& Parameters)
+{
+	if (!FPlatformProcess::SupportsMultithreading())
+	{
+		return true;
+	}
+
+	TSharedRef<FBPTestWebSocket> Socket = MakeShared<FBPTestWebSocket>();
+	FBPOutboundThread Thread;
+	FBPOutboundQueue Queue;
+	Thread.SetSocket(Socket);
+
+	Socket->Hold();
+	AddScalar(Queue, 1, 1);
+	Thread.Send(Finish(Queue));
+	TestTrue(TEXT("Thread started sending"), Socket->WaitForSends(1));
+
+	//Like Disconnect after WaitUntilSent timed out: the socket must not be let go of while it is still being sent on.
+	std::atomic<bool> bReleased { false };
+	TFuture<void> Release = Async(EAsyncExecution::Thread, [&Thread, &bReleased]()
+		{
+			Thread.SetSocket(nullptr);
+			bReleased = true;
+		});
+	FPlatformProcess::Sleep(0.1f);
+	TestFalse(TEXT("SetSocket waits for the send in progress"), bReleased.load());
+
+	Socket->Release();
+	Release.Wait();
+	TestTrue(TEXT("Only we still hold the socket"), Socket.IsUnique());
+
+	//Anything queued now has no socket to go to.
+	AddScalar(Queue, 2, 1);
+	Thread.Send(Finish(Queue));
+	TestTrue(TEXT("Thread.WaitUntilSent"), Thread.WaitUntilSent(5.0));
+	TestEqual(TEXT("Packets sent"), Socket->GetSent().Num(), 1);
+
+	Thread.Shutdown(1.0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBPOutboundStopUnderLoadTest, "ButtplugUE.Outbound.StopUnderLoad",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FBPOutboundStopUnderLoadTest::RunTest(const FString& Parameters)
+{
+	if (!FPlatformProcess::SupportsMultithreading())
+	{
+		return true;
+	}
+
+	constexpr int32 Devices = 4;
+	constexpr int32 QueuedPackets = 64;
+	constexpr int32 StoppedDevice = 1;
+	//Ids carry their device in the last digit, so the wire can be checked without decoding it.
+	auto MakeId = [](int32 Packet, int32 DeviceIndex) { return 100 + Packet * 10 + DeviceIndex; };
+
+	TSharedRef<FBPTestWebSocket> Socket = MakeShared<FBPTestWebSocket>();
+	FBPOutboundThread Thread;
+	FBPOutboundQueue Queue;
+	Thread.SetSocket(Socket);
+
+	//Saturate: the thread is stuck sending one packet, with plenty more behind it and a batch still being built on our side.
+	Socket->Hold();
+	AddScalar(Queue, 1, 0);
+	Thread.Send(Finish(Queue));
+	TestTrue(TEXT("Thread started sending the first packet"), Socket->WaitForSends(1));
+	for (int32 Packet = 0; Packet < QueuedPackets; Packet++)
+	{
+		for (int32 DeviceIndex = 0; DeviceIndex < Devices; DeviceIndex++)
+		{
+			AddScalar(Queue, MakeId(Packet, DeviceIndex), DeviceIndex);
+		}
+		Thread.Send(Finish(Queue));
+	}
+	for (int32 DeviceIndex = 0; DeviceIndex < Devices; DeviceIndex++)
+	{
+		AddScalar(Queue, MakeId(QueuedPackets, DeviceIndex), DeviceIndex);
+	}
+
+	//As UBPDeviceSubsystem::SendStop: take the device's commands out of the batch being built, then send the stop in its own packet.
+	TArray<int32> Removed;
+	Queue.RemoveDeviceCommands(StoppedDevice, Removed);
+	TestEqual(TEXT("Commands removed from the pending batch"), Removed, TArray<int32>({ MakeId(QueuedPackets, StoppedDevice) }));
+	FBPOutboundQueue Priority;
+	constexpr int32 StopId = 5;
+	FBPStopDeviceCmd Stop(StopId, StoppedDevice);
+	Priority.Add(FBPMessageRegistry::GetInfo<FBPStopDeviceCmd>(), &Stop, StopId, StoppedDevice);
+	Thread.SendStop(Finish(Priority), StoppedDevice);
+	Thread.Send(Finish(Queue));
+
+	Socket->Release();
+	TestTrue(TEXT("Everything was sent"), Thread.WaitUntilSent(5.0));
+
+	const TArray<TArray<uint8>> Sent = Socket->GetSent();
+	const int32 StopPacket = Sent.IndexOfByPredicate([](const TArray<uint8>& Packet) { return BPTest::GetMessageIds(Packet).Contains(StopId); });
+	TestEqual(TEXT("The stop is the first packet after the one already being sent"), StopPacket, 1);
+	AddInfo(FString::Printf(TEXT("Stop sent as packet %d of %d, ahead of %d queued packets."), StopPacket, Sent.Num(), QueuedPackets + 1));
+
+	int32 Stale = 0;
+	int32 Others = 0;
+	for (int32 i = StopPacket + 1; i < Sent.Num(); i++)
+	{
+		for (int32 Id : BPTest::GetMessageIds(Sent[i]))
+		{
+			(Id % 10 == StoppedDevice ? Stale : Others)++;
+		}
+	}
+	TestEqual(TEXT("Commands for the stopped device sent after the stop"), Stale, 0);
+	TestEqual(TEXT("Commands for other devices still sent"), Others, (QueuedPackets + 1) * (Devices - 1));
+
+	int32 Dropped = 0;
+	int32 Id;
+	while (Thread.TakeDroppedId(Id))
+	{
+		Dropped++;
+	}
+	TestEqual(TEXT("Overtaken commands reported as dropped"), Dropped, QueuedPackets);
+
+	Thread.Shutdown(1.0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBPOutboundSteadyStateAllocationsTest, "ButtplugUE.Outbound.SteadyStateAllocations",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FBPOutboundSteadyStateAllocationsTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 WarmUpFlushes = 8;
+	constexpr int32 Flushes = 1000;
+
+	//What a game sends each frame: two values for one device (merged), one for another, and a rotation.
+	//Built up front, the caller's own copies are not part of the send path.
+	const FBPScalarCommand First(-1, 1, { FBPScalarObject(0, 0.25, "Vibrate") });
+	const FBPScalarCommand Second(-1, 1, { FBPScalarObject(0, 0.5, "Vibrate"), FBPScalarObject(1, 0.75, "Vibrate") });
+	const FBPScalarCommand Other(-1, 2, { FBPScalarObject(0, 1.0, "Oscillate") });
+	const FBPRotateCommand Rotate(-1, 2, { FBPRotateObject(0, 0.5, true) });
+
+	int32 NextId = 1;
+	//Not initialized, so never connects. Only its scratch messages are used. Game instance subsystems have to live in one.
+	TStrongObjectPtr<UGameInstance> GameInstance(NewObject<UGameInstance>(GetTransientPackage()));
+	TStrongObjectPtr<UBPDeviceSubsystem> Subsystem(NewObject<UBPDeviceSubsystem>(GameInstance.Get()));
+	FBPCommandCoalescer Coalescer;
+	FBPOutboundQueue Queue;
+	FBPOutboundPacket Packet;
+	//As UBPDeviceSubsystem::SendScalarCommand etc. then FlushOutbound, with the packet coming back emptied as it would from the outbound thread.
+	//First and Second are different sizes, so the scalar scratch message shrinks and grows again every flush.
+	auto Flush = [&]()
+		{
+			bool bMerged = false;
+			Coalescer.Add(Subsystem->PrepareCommand(First), [&NextId]() { return NextId++; }, bMerged);
+			Coalescer.Add(Subsystem->PrepareCommand(Second), [&NextId]() { return NextId++; }, bMerged);
+			Coalescer.Add(Subsystem->PrepareCommand(Other), [&NextId]() { return NextId++; }, bMerged);
+			Coalescer.Add(Subsystem->PrepareCommand(Rotate), [&NextId]() { return NextId++; }, bMerged);
+			Coalescer.DrainIf([](int32) { return true; }, [&Queue](auto& Command)
+				{
+					Queue.Add(FBPMessageRegistry::GetInfo<typename TRemoveReference<decltype(Command)>::Type>(), &Command, Command.Id, Command.DeviceIndex);
+				});
+			const bool bFinished = Queue.Finish(Packet);
+			Packet.Reset();
+			return bFinished;
+		};
+
+	for (int32 i = 0; i < WarmUpFlushes; i++)
+	{
+		Flush();
+	}
+	FBPAllocationCounter::Start();
+	int32 Finished = 0;
+	for (int32 i = 0; i < Flushes; i++)
+	{
+		Finished += Flush() ? 1 : 0;
+	}
+	const uint64 Allocations = FBPAllocationCounter::Stop();
+	TestEqual(TEXT("Packets built"), Finished, Flushes);
+	TestEqual(TEXT("Allocations building packets once warmed up"), Allocations, (uint64)0);
+
+	if (!FPlatformProcess::SupportsMultithreading())
+	{
+		return true;
+	}
+
+	//Through the outbound thread, packet buffers come back on the spare list. Once warmed up no new ones should appear.
+	TSharedRef<FBPTestWebSocket> Socket = MakeShared<FBPTestWebSocket>();
+	FBPOutboundThread Thread;
+	Thread.SetSocket(Socket);
+	TSet<const uint8*> Buffers;
+	int32 NewBuffers = 0;
+	for (int32 i = 0; i < WarmUpFlushes + Flushes / 10; i++)
+	{
+		AddScalar(Queue, NextId++, 1);
+		AddScalar(Queue, NextId++, 2);
+		FBPOutboundPacket ToSend = Thread.TakeSparePacket();
+		Queue.Finish(ToSend);
+		bool bSeen = false;
+		Buffers.Add(ToSend.Bytes.GetData(), &bSeen);
+		NewBuffers += i >= WarmUpFlushes && !bSeen ? 1 : 0;
+		Thread.Send(MoveTemp(ToSend));
+		//So the buffer is back on the spare list before the next one is built.
+		Thread.WaitUntilSent(5.0);
+	}
+	TestEqual(TEXT("Packet buffers allocated once warmed up"), NewBuffers, 0);
+
+	Thread.Shutdown(1.0);
+	Thread.SetSocket(nullptr);
+	return true;
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,94 @@
+// Copyright d/Dev 2026
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/MemoryBase.h"
+
+#include <atomic>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/** Counts heap allocations made on one thread, for tests that check a path does not allocate.
+* While counting it sits in front of GMalloc and forwards everything to it, so memory allocated before, during and after
+* can be freed either way. It is never destroyed, as another thread may still be inside it just after it is taken back out.
+*/
+class FBPAllocationCounter : public FMalloc
+{
+public:
+
+	/*Starts counting allocations made on the calling thread.*/
+	static void Start()
+	{
+		FBPAllocationCounter& Counter = Get();
+		check(GMalloc != &Counter);
+		Counter.Thread.store(FPlatformTLS::GetCurrentThreadId());
+		Counter.Count.store(0);
+		Counter.Inner = GMalloc;
+		GMalloc = &Counter;
+	}
+
+	/*Stops counting and returns how many allocations (including reallocations) were made since Start.*/
+	static uint64 Stop()
+	{
+		FBPAllocationCounter& Counter = Get();
+		check(GMalloc == &Counter);
+		GMalloc = Counter.Inner;
+		Counter.Thread.store(0);
+		return Counter.Count.load();
+	}
+
+	// FMalloc Begin
+	virtual void* Malloc(SIZE_T Size, uint32 Alignment) override
+	{
+		Record(Size);
+		return Inner->Malloc(Size, Alignment);
+	}
+	virtual void* TryMalloc(SIZE_T Size, uint32 Alignment) override
+	{
+		Record(Size);
+		return Inner->TryMalloc(Size, Alignment);
+	}
+	virtual void* Realloc(void* Original, SIZE_T Size, uint32 Alignment) override
+	{
+		Record(Size);
+		return Inner->Realloc(Original, Size, Alignment);
+	}
+	virtual void* TryRealloc(void* Original, SIZE_T Size, uint32 Alignment) override
+	{
+		Record(Size);
+		return Inner->TryRealloc(Original, Size, Alignment);
+	}
+	virtual void Free(void* Original) override { Inner->Free(Original); }
+	virtual SIZE_T QuantizeSize(SIZE_T Size, uint32 Alignment) override { return Inner->QuantizeSize(Size, Alignment); }
+	virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+	virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+	virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+	virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+	virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+	virtual const TCHAR* GetDescriptiveName() override { return TEXT("ButtplugUE allocation counter"); }
+	// FMalloc End
+
+private:
+
+	FMalloc* Inner = nullptr;
+	std::atomic<uint32> Thread { 0 };
+	std::atomic<uint64> Count { 0 };
+
+	static FBPAllocationCounter& Get()
+	{
+		static FBPAllocationCounter* Counter = new FBPAllocationCounter();
+		return *Counter;
+	}
+
+	void Record(SIZE_T Size)
+	{
+		//A realloc to 0 is a free.
+		if (Size > 0 && Thread.load(std::memory_order_relaxed) == FPlatformTLS::GetCurrentThreadId())
+		{
+			Count.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+};
+
+#endif //WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,124 @@
+// Copyright d/Dev 2026
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IWebSocket.h"
+#include "HAL/Event.h"
+
+#include <atomic>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/** A websocket for tests that records what is sent instead of sending it.
+* Hold() makes the next Send block until Release(), so packets can be made to pile up behind it on the outbound thread.
+*/
+class FBPTestWebSocket : public IWebSocket
+{
+public:
+
+	FBPTestWebSocket()
+	{
+		Gate = FPlatformProcess::GetSynchEventFromPool(true);
+		Gate->Trigger();
+	}
+
+	virtual ~FBPTestWebSocket() override
+	{
+		FPlatformProcess::ReturnSynchEventToPool(Gate);
+	}
+
+	void Hold() { Gate->Reset(); }
+	void Release() { Gate->Trigger(); }
+
+	/*Waits for Count sends to have started, e.g. for the outbound thread to be blocked inside a held one.*/
+	bool WaitForSends(int32 Count, double TimeoutSeconds = 5.0) const
+	{
+		const double Deadline = FPlatformTime::Seconds() + TimeoutSeconds;
+		while (SendsStarted.load() < Count)
+		{
+			if (FPlatformTime::Seconds() >= Deadline)
+			{
+				return false;
+			}
+			FPlatformProcess::Sleep(0.001f);
+		}
+		return true;
+	}
+
+	TArray<TArray<uint8>> GetSent() const
+	{
+		FScopeLock Lock(&SentLock);
+		return Sent;
+	}
+
+	std::atomic<bool> bConnected { true };
+
+	// IWebSocket Begin
+	virtual void Connect() override { bConnected = true; }
+	virtual void Close(int32 Code = 1000, const FString& Reason = FString()) override { bConnected = false; }
+	virtual bool IsConnected() override { return bConnected; }
+	virtual void Send(const FString& Data) override
+	{
+		FTCHARToUTF8 Utf8(*Data);
+		Send(Utf8.Get(), Utf8.Length(), false);
+	}
+	virtual void Send(const void* Data, SIZE_T Size, bool bIsBinary = false) override
+	{
+		SendsStarted++;
+		Gate->Wait();
+		FScopeLock Lock(&SentLock);
+		Sent.Emplace((const uint8*)Data, (int32)Size);
+	}
+	virtual void SetTextMessageMemoryLimit(uint64 TextMessageMemoryLimit) override {}
+	virtual FWebSocketConnectedEvent& OnConnected() override { return ConnectedEvent; }
+	virtual FWebSocketConnectionErrorEvent& OnConnectionError() override { return ConnectionErrorEvent; }
+	virtual FWebSocketClosedEvent& OnClosed() override { return ClosedEvent; }
+	virtual FWebSocketMessageEvent& OnMessage() override { return MessageEvent; }
+	virtual FWebSocketBinaryMessageEvent& OnBinaryMessage() override { return BinaryMessageEvent; }
+	virtual FWebSocketRawMessageEvent& OnRawMessage() override { return RawMessageEvent; }
+	virtual FWebSocketMessageSentEvent& OnMessageSent() override { return MessageSentEvent; }
+	// IWebSocket End
+
+private:
+
+	FEvent* Gate = nullptr;
+	std::atomic<int32> SendsStarted { 0 };
+
+	mutable FCriticalSection SentLock;
+	TArray<TArray<uint8>> Sent;
+
+	FWebSocketConnectedEvent ConnectedEvent;
+	FWebSocketConnectionErrorEvent ConnectionErrorEvent;
+	FWebSocketClosedEvent ClosedEvent;
+	FWebSocketMessageEvent MessageEvent;
+	FWebSocketBinaryMessageEvent BinaryMessageEvent;
+	FWebSocketRawMessageEvent RawMessageEvent;
+	FWebSocketMessageSentEvent MessageSentEvent;
+};
+
+namespace BPTest
+{
+	/*The Ids of the messages in a packet, in the order they appear. Our writer always puts Id first and writes no whitespace.*/
+	inline TArray<int32> GetMessageIds(TConstArrayView<uint8> Packet)
+	{
+		TArray<int32> Ids;
+		const FAnsiStringView Text((const ANSICHAR*)Packet.GetData(), Packet.Num());
+		const FAnsiStringView Key = "\"Id\":";
+		int32 From = 0;
+		int32 Found;
+		while ((Found = Text.Find(Key, From)) != INDEX_NONE)
+		{
+			From = Found + Key.Len();
+			int32 Id = 0;
+			while (From < Text.Len() && FChar::IsDigit(Text[From]))
+			{
+				Id = Id * 10 + (Text[From++] - '0');
+			}
+			Ids.Add(Id);
+		}
+		return Ids;
+	}
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,87 @@
+// Copyright d/Dev 2026
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "Async/Future.h"
+
+#include "BPTypes.h"
+
+#include "BPAsyncRequestAction.generated.h"
+
+class UBPDeviceSubsystem;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FBPAsyncResponsePin, const FInstancedStruct&, Response);
+
+/** Latent Blueprint nodes for the Device Subsystem's requests, with separate output pins for the response and for failure.
+* Built on the subsystem's *Async functions, so they share its response tracking and timeout, and any number can be in flight at once.
+*/
+UCLASS()
+class BUTTPLUGUE_API UBPAsyncRequestAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+
+public:
+
+	/*Fires with the response to the request, which has the same Id.*/
+	UPROPERTY(BlueprintAssignable)
+	FBPAsyncResponsePin OnResponse;
+
+	/*Fires with an FBPMessageStatusError if Intiface rejected the request, it timed out, or we were not connected.*/
+	UPROPERTY(BlueprintAssignable)
+	FBPAsyncResponsePin OnError;
+
+	/*Requests Server information from Intiface Central. Response struct type is FBPMessageServerInfo*/
+	UFUNCTION(BlueprintCallable, meta = (Category = "ButtplugUE|Devices|Async", BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+	static UBPAsyncRequestAction* RequestServerInfoAsync(UObject* WorldContextObject);
+
+	/*Pings the Intiface Server. Response struct type is FBPMessageStatusOk*/
+	UFUNCTION(BlueprintCallable, meta = (Category = "ButtplugUE|Devices|Async", BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+	static UBPAsyncRequestAction* PingServerAsync(UObject* WorldContextObject);
+
+	/*Requests the device list from Intiface Server. Response struct type is FBPDeviceList*/
+	UFUNCTION(BlueprintCallable, meta = (Category = "ButtplugUE|Devices|Async", BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+	static UBPAsyncRequestAction* RequestDeviceListAsync(UObject* WorldContextObject);
+
+	/*Requests Intiface to stop all activity on the given device. Response struct type is FBPMessageStatusOk*/
+	UFUNCTION(BlueprintCallable, meta = (Category = "ButtplugUE|Devices|Async", BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+	static UBPAsyncRequestAction* StopDeviceAsync(UObject* WorldContextObject, const FBPDeviceObject& Device, bool bStopPatterns = true);
+
+	/*Request Intiface to stop activity on all devices. Response struct type is FBPMessageStatusOk*/
+	UFUNCTION(BlueprintCallable, meta = (Category = "ButtplugUE|Devices|Async", BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+	static UBPAsyncRequestAction* StopAllDevicesAsync(UObject* WorldContextObject, bool bStopPatterns = true);
+
+	/*Request Intiface to start scanning for new devices. Response struct type is FBPMessageStatusOk*/
+	UFUNCTION(BlueprintCallable, meta = (Category = "ButtplugUE|Devices|Async", BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+	static UBPAsyncRequestAction* StartScanningAsync(UObject* WorldContextObject);
+
+	/*Request Intiface to stop scanning for new devices. Response struct type is FBPMessageStatusOk*/
+	UFUNCTION(BlueprintCallable, meta = (Category = "ButtplugUE|Devices|Async", BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+	static UBPAsyncRequestAction* StopScanningAsync(UObject* WorldContextObject);
+
+	/*Send a scalar command to a device. Response struct type is FBPMessageStatusOk*/
+	UFUNCTION(BlueprintCallable, meta = (Category = "ButtplugUE|Devices|Async", BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+	static UBPAsyncRequestAction* SendScalarCommandAsync(UObject* WorldContextObject, const FBPScalarCommand& Command);
+
+	/*Send a linear command to a device. Response struct type is FBPMessageStatusOk*/
+	UFUNCTION(BlueprintCallable, meta = (Category = "ButtplugUE|Devices|Async", BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+	static UBPAsyncRequestAction* SendLinearCommandAsync(UObject* WorldContextObject, const FBPLinearCommand& Command);
+
+	/*Send a rotate command to a device. Response struct type is FBPMessageStatusOk*/
+	UFUNCTION(BlueprintCallable, meta = (Category = "ButtplugUE|Devices|Async", BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+	static UBPAsyncRequestAction* SendRotateCommandAsync(UObject* WorldContextObject, const FBPRotateCommand& Command);
+
+	virtual void Activate() override;
+
+private:
+
+	//Issues the request on the subsystem, set by whichever node created us.
+	TFunction<TFuture<FInstancedStruct>(UBPDeviceSubsystem&)> Request;
+
+	TWeakObjectPtr<UBPDeviceSubsystem> Subsystem;
+
+	static UBPAsyncRequestAction* Create(UObject* WorldContextObject, TFunction<TFuture<FInstancedStruct>(UBPDeviceSubsystem&)>&& InRequest);
+
+	void HandleResponse(const FInstancedStruct& Response);
+};
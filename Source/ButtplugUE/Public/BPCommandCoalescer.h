@@ -0,0 +1,120 @@
+// Copyright d/Dev 2026
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "BPTypes.h"
+
+/** Holds fire-and-forget actuator commands until the next outbound flush, merging them last-write-wins.
+* There is at most one pending command per (device, command type), holding one entry per actuator Index,
+* so any number of Scalar/Linear/Rotate commands for a device in one flush window go out as a single multi-actuator command
+* carrying only the latest value for each actuator. What the device ends up doing is the same, the message count is not.
+* Commands for a device that is being rate limited stay here across flushes (see DrainIf), still merging, until it is ready.
+*/
+class BUTTPLUGUE_API FBPCommandCoalescer
+{
+public:
+
+	/*Merges a command into the pending one for its device. MakeId is only called if this starts a new pending command.
+	Returns the Id the merged command will be sent with, and sets bOutMerged if it joined one already pending.*/
+	int32 Add(const FBPScalarCommand& Command, TFunctionRef<int32()> MakeId, bool& bOutMerged);
+	int32 Add(const FBPLinearCommand& Command, TFunctionRef<int32()> MakeId, bool& bOutMerged);
+	int32 Add(const FBPRotateCommand& Command, TFunctionRef<int32()> MakeId, bool& bOutMerged);
+
+	/*As above for a command held in an instanced struct. Returns -1 if it is not a Scalar, Linear or Rotate command.*/
+	int32 Add(const FInstancedStruct& Command, TFunctionRef<int32()> MakeId, bool& bOutMerged);
+
+	/*Drops pending values for the actuators this command sets, as it is about to be sent on its own and must not be overridden by older values.*/
+	void Remove(const FBPScalarCommand& Command);
+	void Remove(const FBPLinearCommand& Command);
+	void Remove(const FBPRotateCommand& Command);
+
+	/*Drops everything pending for one device, e.g. because it has been told to stop.*/
+	void RemoveDevice(int32 DeviceIndex);
+
+	void Reset();
+
+	bool IsEmpty() const;
+
+	/*Whether anything is pending for a device, of any command type.*/
+	bool IsPending(int32 DeviceIndex) const;
+
+	/*Hands every pending command to Visit, as a mutable FBPScalarCommand&, FBPLinearCommand& or FBPRotateCommand&, then clears them.*/
+	template<typename VisitorType>
+	void Drain(VisitorType&& Visit)
+	{
+		DrainIf([](int32) { return true; }, Visit);
+	}
+
+	/*As Drain, but only for devices ShouldRelease(DeviceIndex) accepts. Commands for any other device stay pending for a later call.*/
+	template<typename PredicateType, typename VisitorType>
+	void DrainIf(PredicateType&& ShouldRelease, VisitorType&& Visit)
+	{
+		DrainIf(Scalars, ShouldRelease, Visit);
+		DrainIf(Linears, ShouldRelease, Visit);
+		DrainIf(Rotates, ShouldRelease, Visit);
+	}
+
+private:
+
+	/*A device's command, kept from one flush to the next once the device has had one, and pending while NumSet > 0.
+	Set marks the actuator entries given a value since the command was last drained. The others are left over from earlier flushes,
+	kept so the next value for that actuator is copied into their allocations (the ActuatorType string among them), and are
+	trimmed off before the command is handed out.*/
+	template<typename CommandType>
+	struct TPending
+	{
+		CommandType Command;
+		TBitArray<> Set;
+		int32 NumSet = 0;
+	};
+
+	//One per device that has had a command, there are only ever a handful so these are searched linearly.
+	TArray<TPending<FBPScalarCommand>> Scalars;
+	TArray<TPending<FBPLinearCommand>> Linears;
+	TArray<TPending<FBPRotateCommand>> Rotates;
+
+	template<typename CommandType>
+	static int32 Merge(TArray<TPending<CommandType>>& Pending, const CommandType& Command, TFunctionRef<int32()> MakeId, bool& bOutMerged);
+
+	template<typename CommandType>
+	static void Unset(TArray<TPending<CommandType>>& Pending, const CommandType& Command);
+
+	template<typename CommandType>
+	static void Clear(TPending<CommandType>& Pending)
+	{
+		Pending.Set.Init(false, GetElements(Pending.Command).Num());
+		Pending.NumSet = 0;
+	}
+
+	template<typename CommandType, typename PredicateType, typename VisitorType>
+	static void DrainIf(TArray<TPending<CommandType>>& Commands, PredicateType& ShouldRelease, VisitorType& Visit)
+	{
+		for (TPending<CommandType>& Pending : Commands)
+		{
+			if (Pending.NumSet > 0 && ShouldRelease(Pending.Command.DeviceIndex))
+			{
+				auto& Elements = GetElements(Pending.Command);
+				for (int32 i = Elements.Num() - 1; i >= 0 && Pending.NumSet < Elements.Num(); i--)
+				{
+					if (!Pending.Set[i])
+					{
+						Elements.RemoveAt(i, 1, EAllowShrinking::No);
+						Pending.Set.RemoveAt(i);
+					}
+				}
+				Visit(Pending.Command);
+				//Visit may have taken entries out (redundant values, say), so this sizes Set from what is left.
+				Clear(Pending);
+			}
+		}
+	}
+
+	static TArray<FBPScalarObject>& GetElements(FBPScalarCommand& Command) { return Command.Scalars; }
+	static TArray<FBPLinearObject>& GetElements(FBPLinearCommand& Command) { return Command.Vectors; }
+	static TArray<FBPRotateObject>& GetElements(FBPRotateCommand& Command) { return Command.Rotations; }
+	static const TArray<FBPScalarObject>& GetElements(const FBPScalarCommand& Command) { return Command.Scalars; }
+	static const TArray<FBPLinearObject>& GetElements(const FBPLinearCommand& Command) { return Command.Vectors; }
+	static const TArray<FBPRotateObject>& GetElements(const FBPRotateCommand& Command) { return Command.Rotations; }
+};
@@ -0,0 +1,36 @@
+// Copyright d/Dev 2026
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FBPOutboundThread;
+
+/** Sets actuator values from any thread, e.g. an audio callback or physics step driving a device, without going through the game thread.
+* Get one from UBPDeviceSubsystem::GetCommandSubmitter() on the game thread, then copy it anywhere. Each call is one lock-free push,
+* the outbound thread merges what has been pushed per device (last value for an actuator wins), snaps it to the actuator's StepCount,
+* and sends it no more often than the device's DeviceMessageTimingGap allows.
+* These are fire-and-forget: they get no response, and skip the redundant command filter and the backpressure the subsystem's own
+* sends go through, so they suit values that change continuously rather than one-off commands. A stop drops any not yet sent.
+* They can be mixed with the subsystem's own commands for the same device: each side waits out the other's timing gap, and a value
+* sent from here means the next one the subsystem sends to that actuator is never dropped as redundant.
+* Every call returns false, doing nothing, once the subsystem has gone or where there are no threads (-nothreading).
+*/
+class BUTTPLUGUE_API FBPCommandSubmitter
+{
+public:
+
+	FBPCommandSubmitter() = default;
+	explicit FBPCommandSubmitter(TWeakPtr<FBPOutboundThread, ESPMode::ThreadSafe> InOutbound);
+
+	bool SetScalar(int32 DeviceIndex, int32 ActuatorIndex, double Scalar, FName ActuatorType);
+	bool SetLinear(int32 DeviceIndex, int32 ActuatorIndex, double Position, int32 DurationMs);
+	bool SetRotate(int32 DeviceIndex, int32 ActuatorIndex, double Speed, bool bClockwise);
+
+	/*Whether the subsystem this came from is still around to send anything.*/
+	bool IsValid() const { return Outbound.IsValid(); }
+
+private:
+
+	TWeakPtr<FBPOutboundThread, ESPMode::ThreadSafe> Outbound;
+};
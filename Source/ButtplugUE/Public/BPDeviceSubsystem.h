@@ -5,12 +5,26 @@
 #include "CoreMinimal.h"
 #include "Subsystems/GameInstanceSubsystem.h"
 #include "Engine/TimerHandle.h"
+#include "Engine/EngineBaseTypes.h"
 #include "IWebSocket.h"
+#include "Async/Future.h"
+#include "Containers/Ticker.h"
 
 #include "BPTypes.h"
+#include "BPMessageRegistry.h"
+#include "BPInFlightTable.h"
+#include "BPLatencyHistogram.h"
+#include "BPOutboundQueue.h"
+#include "BPCommandCoalescer.h"
+#include "BPOutboundThread.h"
+#include "BPCommandSubmitter.h"
+#include "BPInboundThread.h"
+#include "BPShadowState.h"
 
 #include "BPDeviceSubsystem.generated.h"
 
+class FBPPacketTemplate;
+
 /*Delegate declarations for all the different message types
 	Strickly speaking we do not need all of these, however
 	why not just have it all, in case?
@@ -44,9 +58,37 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FBPSensorUnsubscribeCmdDelegate, con
 */
 DECLARE_DYNAMIC_DELEGATE_OneParam(FBPInstancedResponseDelegate, const FInstancedStruct&, Struct);
 
+//Whoever is waiting on a response: a Blueprint delegate, a native callback (used by the *Async functions), or nothing.
+struct FBPResponseHandler
+{
+	FBPInstancedResponseDelegate Delegate;
+	TUniqueFunction<void(const FInstancedStruct&)> Callback;
+
+	FBPResponseHandler() = default;
+	FBPResponseHandler(const FBPInstancedResponseDelegate& InDelegate) : Delegate(InDelegate) {}
+	FBPResponseHandler(TUniqueFunction<void(const FInstancedStruct&)>&& InCallback) : Callback(MoveTemp(InCallback)) {}
+
+	bool IsBound() const { return Delegate.IsBound() || Callback.IsSet(); }
+
+	void Execute(const FInstancedStruct& Response)
+	{
+		Delegate.ExecuteIfBound(Response);
+		if (Callback.IsSet())
+		{
+			Callback(Response);
+		}
+	}
+};
+
+//Fired when a packet from Intiface is rejected by the inbound limits, or is not valid JSON.
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FBPInboundRejectedDelegate, EBPInboundRejectReason, Reason, int32, PacketBytes);
+
 //Blank delegate, for simple triggers.
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FBPBasicDelegate);
 
+//Native (C++ only) counterpart to the events above, one per message type. Skips the Blueprint VM and passes the message by reference.
+DECLARE_MULTICAST_DELEGATE_OneParam(FBPNativeMessageDelegate, const FInstancedStruct&);
+
 class UBPManagedCommand;
 class UCurveFloat;
 
@@ -112,27 +154,291 @@ public:
 	FBPSensorUnsubscribeCmdDelegate OnSensorUnsubscribeCommandReceived;
 	UPROPERTY(BlueprintAssignable, Meta = (Category = "ButtplugUE|Events"))
 	FBPBasicDelegate OnServerDisconnect;
+	UPROPERTY(BlueprintAssignable, Meta = (Category = "ButtplugUE|Events"))
+	FBPInboundRejectedDelegate OnInboundPacketRejected;
 
 	/*Subsystem Native Functions*/
 
 	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
 	virtual void Deinitialize() override;
 
+	/*Native event for a message type, for C++ listeners that want to avoid the cost of the Blueprint events.
+	Fires before the Blueprint event of the same type.*/
+	FBPNativeMessageDelegate& OnNativeMessage(EBPMessageType Type) { return NativeMessageDelegates[(uint8)Type]; }
+
+	/*Binds any callable taking a const T& to the native event for message type T.
+	e.g. AddNativeListener<FBPSensorReading>([this](const FBPSensorReading& Reading) { ... });*/
+	template<typename T, typename FunctorType>
+	FDelegateHandle AddNativeListener(FunctorType&& Functor)
+	{
+		return OnNativeMessage(FBPMessageRegistry::GetInfo<T>().Type).AddLambda(
+			[Functor = Forward<FunctorType>(Functor)](const FInstancedStruct& Message) { Invoke(Functor, Message.Get<T>()); });
+	}
+
+	void RemoveNativeListener(EBPMessageType Type, FDelegateHandle Handle) { OnNativeMessage(Type).Remove(Handle); }
+
+	/*Snaps a value for one of a device's actuators to its step grid (see UBPTypes::QuantizeActuatorValue).
+	Actuators is the list in FBPDeviceMessages the actuator belongs to, e.g. &FBPDeviceMessages::ScalarCmd.*/
+	double QuantizeActuatorValue(int32 DeviceIndex, TArray<FBPCommandMessage> FBPDeviceMessages::*Actuators, int32 ActuatorIndex, double Value) const;
+
+	/*Sends a precompiled packet, patching in a fresh message Id first. No response delegate, returns the Id or -1 if not connected.
+	If Source is the command the template was compiled from (with its current values), it is held and merged with other commands
+	for the same device instead while the device is not ready, or (when coalescing) has others waiting for the flush.*/
+	int32 SendPacketTemplate(FBPPacketTemplate& Template, const FInstancedStruct* Source = nullptr);
+
+	/*A handle for setting actuator values from other threads (audio, physics, workers), see FBPCommandSubmitter.*/
+	FBPCommandSubmitter GetCommandSubmitter() const { return FBPCommandSubmitter(OutboundThread); }
+
+	/*Sends everything queued so far as one packet now, rather than waiting for the flush point in OutboundFlushMode.
+	Use after a message that must not wait for the end of the frame.*/
+	UFUNCTION(BlueprintCallable, meta = (Category = "ButtplugUE|Devices"))
+	void FlushOutbound();
+
+	/*C++ versions of the requests below that return a future instead of taking a delegate, so no UFUNCTION is needed to get a reply
+	and any number of them can be outstanding at once. The future is set on the game thread, with the response carrying the
+	request's Id, or with an FBPMessageStatusError if the request timed out, the connection closed or we were never connected.
+	co_await them from a C++20 coroutine with BPResponseAwaitable.h, or use UBPAsyncRequestAction from Blueprint.*/
+	TFuture<FInstancedStruct> RequestServerInfoAsync();
+	TFuture<FInstancedStruct> PingServerAsync();
+	TFuture<FInstancedStruct> RequestDeviceListAsync();
+	TFuture<FInstancedStruct> StopDeviceAsync(const FBPDeviceObject& Device, bool bStopPatterns = true);
+	TFuture<FInstancedStruct> StopAllDevicesAsync(bool bStopPatterns = true);
+	TFuture<FInstancedStruct> StartScanningAsync();
+	TFuture<FInstancedStruct> StopScanningAsync();
+	TFuture<FInstancedStruct> SendScalarCommandAsync(const FBPScalarCommand& Command);
+	TFuture<FInstancedStruct> SendLinearCommandAsync(const FBPLinearCommand& Command);
+	TFuture<FInstancedStruct> SendRotateCommandAsync(const FBPRotateCommand& Command);
+
+	/*Round trip times of requests of one type, from sending to Intiface's reply with the same Id (usually Ok or Error).*/
+	const FBPLatencyHistogram& GetLatencyHistogram(EBPMessageType Type) const { return TypeLatency[(uint8)Type]; }
+
+	/*Round trip times of requests to one device, or nullptr if none have been answered yet.*/
+	const FBPLatencyHistogram* FindDeviceLatencyHistogram(int32 DeviceIndex) const { return DeviceLatency.Find(DeviceIndex); }
+
+	/*Round trip latency of requests of one type (ScalarCmd, RequestDeviceList...), for spotting Bluetooth congestion or server load.*/
+	UFUNCTION(BlueprintCallable, BlueprintPure, meta = (Category = "ButtplugUE|Debug"))
+	FBPLatencySummary GetMessageLatency(EBPMessageType Type) const;
+
+	/*Round trip latency of all requests to one device.*/
+	UFUNCTION(BlueprintCallable, BlueprintPure, meta = (Category = "ButtplugUE|Debug"))
+	FBPLatencySummary GetDeviceLatency(int32 DeviceIndex) const;
+
+	UFUNCTION(BlueprintCallable, meta = (Category = "ButtplugUE|Debug"))
+	void ResetLatencyStats();
+
+	/*Shortest time between fire-and-forget commands to a device: its DeviceMessageTimingGap, or longer while it is slow to answer.
+	0 if it is not being rate limited. Patterns update no faster than this.*/
+	UFUNCTION(BlueprintCallable, BlueprintPure, meta = (Category = "ButtplugUE|Debug"))
+	float GetDeviceCommandInterval(int32 DeviceIndex) const;
+
+	/*How many actuator commands sent to a device have not been answered yet.*/
+	UFUNCTION(BlueprintCallable, BlueprintPure, meta = (Category = "ButtplugUE|Debug"))
+	int32 GetUnackedCommandCount(int32 DeviceIndex) const;
+
+	/*How many packets from Intiface have been rejected, see OnInboundPacketRejected.*/
+	UFUNCTION(BlueprintCallable, BlueprintPure, meta = (Category = "ButtplugUE|Debug"))
+	int32 GetRejectedPacketCount() const { return RejectedPacketCount; }
+
+	/*How many received messages were not decoded because nothing was bound to their type and no response was waiting on their Id.*/
+	UFUNCTION(BlueprintCallable, BlueprintPure, meta = (Category = "ButtplugUE|Debug"))
+	int64 GetSkippedMessageCount() const { return SkippedMessageCount; }
+
 private:
 
 	//Our websocket reference
 	TSharedPtr<IWebSocket> Socket;
 
-	//Our map of Response Delegates, mapping their message Id to the relevant delegate
-	UPROPERTY()
-	TMap<int32, FBPInstancedResponseDelegate> ResponseDelegates;
+	//Messages waiting for the next flush, already serialized into one packet. Reused, so sending does not allocate once it has grown to fit.
+	FBPOutboundQueue Outbound;
+	//Stops are serialized here instead, and sent on their own straight away rather than at the next flush.
+	FBPOutboundQueue PriorityOutbound;
+
+	//Does the actual Socket->Send for finished packets, off the game thread.
+	//Shared with any FBPCommandSubmitter handed out, which may still be holding it from another thread as we shut down.
+	TSharedPtr<FBPOutboundThread, ESPMode::ThreadSafe> OutboundThread;
+	EBPOutboundFlushMode FlushMode = EBPOutboundFlushMode::EndOfFrame;
+	FDelegateHandle FlushHandle;
+
+	//Fire-and-forget actuator commands waiting for the flush, merged per device. See bCoalesceCommands.
+	FBPCommandCoalescer Coalescer;
+	bool bCoalesceCommands = false;
+
+	//What each actuator was last sent, so commands that change nothing can be dropped. See bSuppressRedundantCommands.
+	FBPShadowState Shadow;
+	bool bSuppressRedundant = false;
+
+	//Per device send pacing. See bRateLimitDevices and MaxUnackedCommands.
+	//Commands for a device that is not ready yet wait in the coalescer, so only the newest value goes out once it is.
+	struct FDeviceFlow
+	{
+		double ReadyTime = 0.0;		//When the device may next be sent a fire-and-forget command.
+		double Backoff = 0.0;		//Extra spacing on top of DeviceMessageTimingGap while the device is slow to answer.
+		int32 Unacked = 0;			//Actuator commands sent and not yet answered.
+	};
+	TMap<int32, FDeviceFlow> DeviceFlows;
+	bool bRateLimit = false;
+	int32 MaxUnacked = 0;
+	double LatencyTarget = 0.0;
+
+	bool IsDeviceReady(int32 DeviceIndex, double Now) const;
+	void DelayDevice(int32 DeviceIndex, double Now);
+	void OnDeviceCommandSent(int32 DeviceIndex);
+	void OnDeviceCommandAnswered(int32 DeviceIndex, bool bSucceeded, double Latency);
+
+	//Sends an actuator command, through the coalescer if nothing is waiting on its reply.
+	//Returns its Id, or 0 if it was dropped for changing nothing.
+	template<typename T>
+	int32 SendCommand(FBPResponseHandler Response, T& Command);
+
+	//Writes a fire-and-forget command (with its Id already set) into the outbound packet, unless it changes nothing.
+	template<typename T>
+	void WriteCommand(T& Command);
+
+	//Drops anything pending or remembered for a device that has just been told to stop, or for all of them.
+	void ForgetDevice(int32 DeviceIndex);
+	void ForgetAllDevices();
+
+	//Flushes after adding a message if we are not batching, or the batch has grown too big.
+	void OnMessageQueued();
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	//Reassembly buffer for inbound frames that arrive in fragments, reused in the same way.
+	TArray<uint8> ReceiveBuffer;
+
+	//Set once a fragmented frame goes over MaxInboundPacketBytes, the rest of it is dropped as it arrives rather than buffered.
+	bool bDiscardingFrame = false;
+	int32 DiscardedFrameBytes = 0;
+
+	//Packets rejected since the subsystem started.
+	int32 RejectedPacketCount = 0;
+	void RejectPacket(EBPInboundRejectReason Reason, int32 PacketBytes);
+
+	//Messages decoded from the current frame, kept around so its allocation is reused. Only used when parsing inline.
+	TArray<FBPDecodedMessage> DecodedMessages;
+
+	//Parses frames off the game thread, its records are dispatched from DrainInbound once a frame.
+	TUniquePtr<FBPInboundThread> InboundThread;
+	FTSTicker::FDelegateHandle InboundTickHandle;
+	bool OnInboundTick(float DeltaTime);
+
+	//Dispatches up to MaxMessages parsed records (0 for all of them).
+	void DrainInbound(int32 MaxMessages);
+
+	//Waits for frames already received to be parsed and dispatches them, before the connection they came from is cleaned up.
+	void FlushInbound();
+
+	//Updates our own state from a decoded message, then hands it to its delegates and any waiting response.
+	void DispatchMessage(const FBPDecodedMessage& Decoded);
+	//Just the delegates part of DispatchMessage, native listeners first.
+	void NotifyListeners(EBPMessageType Type, const FInstancedStruct& Message);
+
+	TStaticArray<FBPNativeMessageDelegate, (uint8)EBPMessageType::MAX> NativeMessageDelegates;
+
+	//Fires the Blueprint event for message type T, if anything is bound to it.
+	template<typename T, auto Event>
+	void BroadcastMessage(const FInstancedStruct& Message);
+
+	template<auto Event>
+	bool IsEventBound() const;
+
+	//The Blueprint event for one message type, indexed by EBPMessageType in GetDispatchTable().
+	struct FDispatchEntry
+	{
+		void (UBPDeviceSubsystem::*Broadcast)(const FInstancedStruct&) = nullptr;
+		bool (UBPDeviceSubsystem::*IsBound)() const = nullptr;
+	};
+	using FDispatchTable = TStaticArray<FDispatchEntry, (uint8)EBPMessageType::MAX>;
+	static const FDispatchTable& GetDispatchTable();
+
+	template<typename T, auto Event>
+	static FDispatchEntry MakeDispatchEntry();
+
+	//Whether anything would see a message of this type and Id, if not we skip decoding it.
+	bool WantsMessage(EBPMessageType Type, int32 Id) const;
+	bool WantsType(EBPMessageType Type) const;
+
+	//A bit per EBPMessageType that WantsType, for the inbound thread.
+	uint32 GetWantedTypes() const;
+
+	//Devices as last reported by Intiface, kept so outbound values can be snapped to each actuator's StepCount.
+	TMap<int32, FBPDeviceObject> KnownDevices;
+	void UpdateKnownDevices(const FBPDecodedMessage& Message);
+
+	//StepCount of one actuator of a known device, or -1 if we do not know it.
+	int32 GetStepCount(int32 DeviceIndex, TArray<FBPCommandMessage> FBPDeviceMessages::*Actuators, int32 ActuatorIndex) const;
+
+	//When each request still waiting on a reply was sent, indexed by Id like the response table, so replies can be timed whether or not anyone waits on them.
+	//A request is only written off as lost once it times out (or the table fills), so a slow reply is still matched however much was sent after it.
+	struct FSentRecord
+	{
+		EBPMessageType Type = EBPMessageType::MAX;
+		int32 DeviceIndex = INDEX_NONE;
+		double SentAt = 0.0;
+	};
+	using FSentTable = TBPInFlightTable<FSentRecord>;
+	FSentTable SentLog;
+
+	TStaticArray<FBPLatencyHistogram, (uint8)EBPMessageType::MAX> TypeLatency;
+	TMap<int32, FBPLatencyHistogram> DeviceLatency;
+
+	void RecordSent(int32 Id, EBPMessageType Type, int32 DeviceIndex);
+	void RecordReply(EBPMessageType Type, int32 Id, double ReceivedAt);
+	void WriteOffSent(const FSentRecord& Sent);
+
+	//Messages skipped by WantsMessage since the subsystem started.
+	int64 SkippedMessageCount = 0;
+
+	//Identifies an idempotent query (the device list, server info, one sensor's reading), so identical ones can share a request and its answer.
+	struct FQueryKey
+	{
+		EBPMessageType Type = EBPMessageType::MAX;
+		int32 DeviceIndex = -1;
+		int32 SensorIndex = -1;
+		FString SensorType;
+
+		bool operator==(const FQueryKey& Other) const
+		{
+			return Type == Other.Type && DeviceIndex == Other.DeviceIndex && SensorIndex == Other.SensorIndex && SensorType == Other.SensorType;
+		}
+
+		friend uint32 GetTypeHash(const FQueryKey& Key)
+		{
+			return HashCombine(HashCombine(GetTypeHash((uint8)Key.Type), GetTypeHash(Key.DeviceIndex)),
+				HashCombine(GetTypeHash(Key.SensorIndex), GetTypeHash(Key.SensorType)));
+		}
+	};
+
+	struct FQueryState
+	{
+		int32 InFlightId = INDEX_NONE;
+		TArray<FBPResponseHandler> Waiters;	//Everyone asking while the request was in flight, all get its answer.
+		bool bStale = false;				//Devices changed while in flight, so do not cache the answer.
+		FInstancedStruct CachedResponse;
+		double CachedUntil = 0.0;
+	};
+	TMap<FQueryKey, FQueryState> Queries;
+
+	//Answers from the cache if it is fresh, joins the request in flight if there is one, otherwise sends a new one. Returns the Id the answer carries.
+	template<typename T, typename... TArgs>
+	int32 SendQuery(FBPResponseHandler Response, const FQueryKey& Key, TArgs&&... InArgs);
+	void CompleteQuery(const FQueryKey& Key, const FInstancedStruct& Response);
+
+	//Drops cached answers that depend on which devices are connected.
+	void InvalidateDeviceQueries();
+
+	//Response handlers waiting on a reply, indexed by their message Id.
+	//Requests that are never answered time out (firing an Error response) rather than waiting forever.
+	using FResponseTable = TBPInFlightTable<FBPResponseHandler>;
+	FResponseTable ResponseDelegates;
 
-	//We are storing and iterating the message Id.
-	//Could use a random int each time, but this way in the case of a bug report
-	//we can see how many messages have been sent, which might tie to how long the
-	//instance has been running. Just another data point which might be of use.
 	UPROPERTY()
-	int32 MessageIdCounter;
+	FTimerHandle ResponseTimeoutTimer;
+	void ExpireResponses();
+
+	//Fires a response handler with an Error message, for requests that will never get a real reply.
+	void FailResponse(FResponseTable::FEntry& Entry, const FString& Reason);
+
+	//Ids come from the outbound thread, so values sent through FBPCommandSubmitter share the same sequence.
 	int32 MakeMessageId();
 
 	//Used internally if the Intiface Server requests a regular ping/heartbeat.
@@ -143,7 +449,8 @@ private:
 	void OnConnected();
 	void OnConnectionError(const FString& Error);
 	void OnClosed(int32 StatusCode, const FString& Reason, bool bWasClean);
-	void OnMessage(const FString& Message);
+	void OnMessage(TConstArrayView<uint8> Message);
+	void OnFrameReceived(TConstArrayView<uint8> Frame);
 	void OnRawMessage(const void* Data, SIZE_T Size, SIZE_T BytesRemaining);
 	void OnMessageSent(const FString& MessageString);
 
@@ -151,9 +458,68 @@ private:
 	UFUNCTION(Meta = (Category = "ButtplugUE|Devices"))
 	void OnServerHandshake(const FBPMessageServerInfo& ServerInfo);
 
-	//Templated function for wrapping messages and sending to Intiface.
+	//Templated function for wrapping messages and sending to Intiface. Builds the message on the stack, then sends it as below.
+	template<typename T, typename... TArgs>
+	int32 PackAndSendMessage(FBPResponseHandler Response, TArgs&&... InArgs);
+
+	//Gives Message a fresh Id and serializes it straight into the outbound packet, no copies made.
+	template<typename T>
+	int32 SendMessage(FBPResponseHandler Response, T& Message);
+
+	//As above, but the response sets the returned future. Fails it straight away if we are not connected.
+	template<typename T>
+	TFuture<FInstancedStruct> SendMessageAsync(T& Message);
+
+	//The fast lane for StopDeviceCmd/StopAllDevices (DeviceIndex INDEX_NONE). Drops everything still waiting to go to the device,
+	//then sends the stop in a packet of its own there and then, skipping batching, coalescing and rate limiting.
+	//Its round trip shows up in GetMessageLatency like any other request.
 	template<typename T, typename... TArgs>
-	int32 PackAndSendMessage(TOptional<FBPInstancedResponseDelegate> ResponseDelegate, TArgs&&... InArgs);
+	int32 SendStop(FBPResponseHandler Response, int32 DeviceIndex, TArgs&&... InArgs);
+
+	//Takes actuator commands for a device (or all of them) back out of the outbound packet, failing any response waiting on them.
+	void DropPendingCommands(int32 DeviceIndex);
+	//Same for the ones a stop took back out of packets already on the outbound thread.
+	void CollectDroppedCommands();
+	void ForgetDroppedCommand(int32 Id);
+	//Takes in what the outbound thread has sent for FBPCommandSubmitter, so commands from here to the same actuators are paced after it
+	//and are not dropped as redundant against a value it has since replaced.
+	void CollectSubmittedSends();
+
+	//Keeps a response handler until the reply to MessageId arrives or times out. Unbound handlers are not kept.
+	void TrackResponse(int32 MessageId, FBPResponseHandler&& Response);
+
+	//Closes the packet being built in Queue and passes it to the outbound thread.
+	void SendPacket(FBPOutboundQueue& Queue);
+	//Closes the packet being built in Queue into OutPacket. False if it was empty or there is no connection to send it on.
+	bool TakePacket(FBPOutboundQueue& Queue, FBPOutboundPacket& OutPacket);
+
+	//Hands Send a handler that sets the returned future, for the async versions of the send functions.
+	TFuture<FInstancedStruct> SendAsync(TFunctionRef<void(FBPResponseHandler&&)> Send);
+
+	template<typename T, typename... TArgs>
+	TFuture<FInstancedStruct> PackAndSendMessageAsync(TArgs&&... InArgs);
+
+	//Stops the pattern commands running on one device, or on all of them, leaving the caller to stop the device itself.
+	void StopDevicePatterns(const FBPDeviceObject& Device);
+	void StopAllPatterns();
+
+	//One reusable instance per message type for commands with arrays (actuator values etc.), filled in and sent in place.
+	//Their arrays keep their allocations between sends, so once warmed up a command send does not touch the heap.
+	TStaticArray<FInstancedStruct, (uint8)EBPMessageType::MAX> ScratchMessages;
+
+	template<typename T>
+	T& GetScratchMessage();
+
+	//Scalar entries the scratch command has shrunk out of, kept with their ActuatorType strings for when it grows again.
+	TArray<FBPScalarObject> SpareScalars;
+
+	//Copies a command into its scratch message with every value snapped to its actuator's StepCount, ready to send.
+	FBPScalarCommand& PrepareCommand(const FBPScalarCommand& Command);
+	FBPLinearCommand& PrepareCommand(const FBPLinearCommand& Command);
+	FBPRotateCommand& PrepareCommand(const FBPRotateCommand& Command);
+
+	//Checks the scratch path stops allocating once warmed up, by calling PrepareCommand directly.
+	friend class FBPOutboundSteadyStateAllocationsTest;
 
 	UPROPERTY()
 	TMap<FGuid, UBPManagedCommand*> ManagedCommands;
@@ -173,6 +539,7 @@ public:
 	void Disconnect();
 
 	/*Requests Server information from Intiface Central
+		Calls made while one is already waiting on Intiface share its answer, and the answer is reused for ServerInfoCacheSeconds.
 	
 	@param Response		The response delegate for this specific message, fires when a response is recieved. Struct type is FBPMessageServerInfo
 	*/
@@ -187,6 +554,8 @@ public:
 	void PingServer(FBPInstancedResponseDelegate Response);
 
 	/*Requests the device list from Intiface Server.
+		Calls made while one is already waiting on Intiface share its answer, and the answer is reused for DeviceListCacheSeconds
+		or until a device is added or removed. A reused answer fires Response straight away.
 
 	@param Response		The response delegate for this specific message, fires when a response is received. Struct type is FBPDeviceList
 	*/
@@ -0,0 +1,184 @@
+// Copyright d/Dev 2026
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace BPInFlight
+{
+	//How many requests can be waiting on a response at once. Anything mirroring the response table elsewhere is sized from this too.
+	constexpr int32 DefaultCapacity = 256;
+}
+
+/** Fixed-capacity table of requests waiting on a response, keyed by message Id.
+* Ids are handed out sequentially, so Id modulo the capacity is the home slot with no hashing, and since every request gets the
+* same timeout, the order they were added in is also the order they expire in. Slots are threaded onto an intrusive
+* oldest-first list, which makes expiry a pop from the front rather than a scan.
+* Most Ids are for messages nobody waits on, so a request can still be waiting when a later one lands on its home slot.
+* The later one then takes the next free slot along, and lookups check as far along as any request has had to go.
+* That distance is only reset once the table empties, but with sequential Ids it is almost always 0.
+* Only if the table is full is the oldest request evicted to make room, so memory is bounded however long the session runs.
+* Ids wrap round after INT32_MAX, by which point anything added under the same Id has long since expired.
+* Reset() bumps a generation counter, so nothing added before it can be matched afterwards (stale replies after a reconnect).
+*/
+template<typename PayloadType, int32 Capacity = BPInFlight::DefaultCapacity>
+class TBPInFlightTable
+{
+	static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two.");
+
+public:
+
+	struct FEntry
+	{
+		int32 Id = 0;
+		PayloadType Payload;
+	};
+
+	TBPInFlightTable()
+	{
+		Slots.SetNum(Capacity);
+	}
+
+	/*Adds a request. If the table is full the oldest request is evicted into OutEvicted and true is returned.*/
+	bool Add(int32 Id, PayloadType Payload, double Deadline, FEntry& OutEvicted)
+	{
+		const bool bEvicted = Count == Capacity && Take(Head, OutEvicted);
+
+		int32 Index = ToIndex(Id);
+		int32 Distance = 0;
+		while (IsLive(Index))
+		{
+			Index = (Index + 1) & (Capacity - 1);
+			Distance++;
+		}
+		MaxDistance = FMath::Max(MaxDistance, Distance);
+
+		FSlot& Slot = Slots[Index];
+		Slot.Id = Id;
+		Slot.Generation = Generation;
+		Slot.Deadline = Deadline;
+		Slot.Payload = MoveTemp(Payload);
+		Link(Index);
+		return bEvicted;
+	}
+
+	bool Contains(int32 Id) const
+	{
+		return Find(Id) != INDEX_NONE;
+	}
+
+	/*Removes the request with this Id, if it is still waiting, handing back its payload.*/
+	bool Remove(int32 Id, PayloadType& OutPayload)
+	{
+		const int32 Index = Find(Id);
+		if (Index == INDEX_NONE)
+		{
+			return false;
+		}
+
+		FEntry Entry;
+		Take(Index, Entry);
+		OutPayload = MoveTemp(Entry.Payload);
+		return true;
+	}
+
+	/*Removes the oldest request if its deadline has passed. Call until it returns false.*/
+	bool PopExpired(double Now, FEntry& OutExpired)
+	{
+		if (Head == INDEX_NONE || Slots[Head].Deadline > Now)
+		{
+			return false;
+		}
+		return Take(Head, OutExpired);
+	}
+
+	/*Drops every request, oldest first, into OutPending, and starts a new generation.*/
+	void Reset(TArray<FEntry>& OutPending)
+	{
+		while (Head != INDEX_NONE)
+		{
+			Take(Head, OutPending.AddDefaulted_GetRef());
+		}
+		Generation++;
+	}
+
+	int32 Num() const { return Count; }
+
+private:
+
+	struct FSlot
+	{
+		int32 Id = 0;
+		uint32 Generation = 0;
+		double Deadline = 0.0;
+		int32 Prev = INDEX_NONE;
+		int32 Next = INDEX_NONE;
+		bool bLive = false;
+		PayloadType Payload;
+	};
+
+	TArray<FSlot> Slots;
+	int32 Head = INDEX_NONE;	//Oldest
+	int32 Tail = INDEX_NONE;	//Newest
+	int32 Count = 0;
+	uint32 Generation = 1;
+	//No live request is further than this from its home slot.
+	int32 MaxDistance = 0;
+
+	static int32 ToIndex(int32 Id) { return (int32)((uint32)Id & (Capacity - 1)); }
+
+	int32 Find(int32 Id) const
+	{
+		int32 Index = ToIndex(Id);
+		for (int32 Distance = 0; Distance <= MaxDistance; Distance++)
+		{
+			if (IsLive(Index) && Slots[Index].Id == Id)
+			{
+				return Index;
+			}
+			Index = (Index + 1) & (Capacity - 1);
+		}
+		return INDEX_NONE;
+	}
+
+	bool IsLive(int32 Index) const
+	{
+		return Slots[Index].bLive && Slots[Index].Generation == Generation;
+	}
+
+	void Link(int32 Index)
+	{
+		FSlot& Slot = Slots[Index];
+		Slot.bLive = true;
+		Slot.Prev = Tail;
+		Slot.Next = INDEX_NONE;
+		if (Tail != INDEX_NONE)
+		{
+			Slots[Tail].Next = Index;
+		}
+		else
+		{
+			Head = Index;
+		}
+		Tail = Index;
+		Count++;
+	}
+
+	bool Take(int32 Index, FEntry& OutEntry)
+	{
+		FSlot& Slot = Slots[Index];
+		if (Slot.Prev != INDEX_NONE) { Slots[Slot.Prev].Next = Slot.Next; } else { Head = Slot.Next; }
+		if (Slot.Next != INDEX_NONE) { Slots[Slot.Next].Prev = Slot.Prev; } else { Tail = Slot.Prev; }
+
+		OutEntry.Id = Slot.Id;
+		OutEntry.Payload = MoveTemp(Slot.Payload);
+		Slot.Payload = PayloadType();
+		Slot.bLive = false;
+		Slot.Prev = Slot.Next = INDEX_NONE;
+		if (--Count == 0)
+		{
+			MaxDistance = 0;
+		}
+		return true;
+	}
+};
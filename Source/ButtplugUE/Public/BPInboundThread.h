@@ -0,0 +1,121 @@
+// Copyright d/Dev 2026
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "Containers/Queue.h"
+
+#include <atomic>
+
+#include "BPTypes.h"
+#include "BPSpscRing.h"
+#include "BPInFlightTable.h"
+
+class FRunnableThread;
+class FEvent;
+
+//One parsed message, or one rejected packet, waiting for the game thread.
+struct FBPInboundRecord
+{
+	//Decoded.Message is left empty if nothing wanted the message, only its title and Id were read.
+	FBPDecodedMessage Decoded;
+	int32 Id = 0;
+	double ReceivedAt = 0.0;
+
+	//Set instead on a record reporting a packet that was rejected.
+	EBPInboundRejectReason Rejected = EBPInboundRejectReason::None;
+	int32 PacketBytes = 0;
+};
+
+/** Parses inbound frames on a thread of its own, so a burst of SensorReading or DeviceList messages does not land in one game frame.
+* The game thread queues each complete frame, the thread decodes it into preallocated records, and the game thread drains those
+* through a single-producer/single-consumer ring at its own pace, leaving only delegate dispatch for it to do.
+* Which messages are worth decoding is decided up front from the types with listeners (passed with each frame)
+* and the Ids responses are waiting on, the same as the inline path. Everything else still yields a record with its type and Id, for latency tracking.
+* Where threads are not available IsRunning() is false and frames should be parsed inline instead.
+*/
+class BUTTPLUGUE_API FBPInboundThread : public FRunnable
+{
+public:
+
+	static constexpr int32 RecordCapacity = 1024;
+
+	explicit FBPInboundThread(UObject* InLogContext);
+	virtual ~FBPInboundThread() override;
+
+	bool IsRunning() const { return Thread != nullptr; }
+
+	/*Game thread. Copies a complete frame to be parsed. WantedTypes has a bit set for each EBPMessageType that has listeners.*/
+	void Parse(TConstArrayView<uint8> Frame, uint32 WantedTypes);
+
+	/*Game thread. A reply with this Id will be decoded whatever its type, as a response is waiting on it.
+	IsStillAwaited says which Ids awaited earlier are still waiting, so their slots are not reused.*/
+	void AwaitResponse(int32 Id, TFunctionRef<bool(int32 Id)> IsStillAwaited);
+
+	/*Game thread. The oldest parsed record, or nullptr if there are none. Pop() it once done with it.*/
+	FBPInboundRecord* Peek() { return Records.Peek(); }
+	void Pop() { Records.Pop(); }
+
+	/*Game thread. Messages skipped over since the last call.*/
+	int32 TakeSkippedCount() { return SkippedCount.exchange(0, std::memory_order_relaxed); }
+
+	/*Blocks until every queued frame has been parsed into records, or TimeoutSeconds pass. Returns false on timeout.*/
+	bool WaitUntilParsed(double TimeoutSeconds);
+
+	/*Stops the thread, dropping any frames it has not parsed yet.*/
+	void Shutdown();
+
+	// FRunnable Begin
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+	// FRunnable End
+
+private:
+
+	struct FFrame
+	{
+		TArray<uint8> Bytes;
+		uint32 WantedTypes = 0;
+	};
+
+	TQueue<FFrame, EQueueMode::Spsc> Frames;
+	TQueue<TArray<uint8>, EQueueMode::Spsc> SpareBuffers;
+	TBPSpscRing<FBPInboundRecord, RecordCapacity> Records;
+
+	//Ids responses are waiting on, as many as the response table can hold. Each goes in the first slot from Id modulo the capacity
+	//that is not still awaited, so one left waiting is never overwritten. Only the game thread writes them.
+	//A stale entry only means a message is decoded needlessly.
+	static constexpr int32 AwaitedCapacity = BPInFlight::DefaultCapacity;
+	std::atomic<int32> AwaitedIds[AwaitedCapacity] = {};
+	//No awaited Id is further than this from its first slot.
+	std::atomic<int32> AwaitedMaxDistance { 0 };
+
+	bool IsAwaited(int32 Id) const;
+
+	std::atomic<int32> PendingFrames { 0 };
+	std::atomic<int32> SkippedCount { 0 };
+
+	FRunnableThread* Thread = nullptr;
+	FEvent* WorkEvent = nullptr;
+	std::atomic<bool> bStopping { false };
+
+	//For log messages about bad packets.
+	UObject* LogContext = nullptr;
+
+	//The frame being parsed, reused between frames and only touched by the thread.
+	//Every message's title and Id in order, and the ones that were decoded, so records can go out in the order they arrived.
+	struct FHeader
+	{
+		EBPMessageType Type = EBPMessageType::MAX;
+		int32 Id = 0;
+		bool bDecode = false;
+	};
+	TArray<FHeader> Headers;
+	TArray<FBPDecodedMessage> Decoded;
+
+	void ParseFrame(const FFrame& Frame);
+
+	//Waits for the game thread to free a record if the ring is full. nullptr if the thread is stopping.
+	FBPInboundRecord* BeginRecord();
+};
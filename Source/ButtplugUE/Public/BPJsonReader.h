@@ -0,0 +1,101 @@
+// Copyright d/Dev 2026
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Pull-style JSON reader over a UTF-8 byte buffer, the inbound counterpart to FBPJsonWriter.
+* There is no DOM: the caller walks the document token by token and writes values straight to where they belong.
+* Typed reads (ReadInt, ReadString, ...) return false without consuming anything if the next value is of another type,
+* so the caller can SkipValue() and carry on. Malformed input, or input over the reader's limits, puts the reader in an error state,
+* after which every call fails.
+*/
+class BUTTPLUGUE_API FBPJsonReader
+{
+public:
+
+	enum class EValueType : uint8
+	{
+		None,
+		Object,
+		Array,
+		String,
+		Number,
+		Bool,
+		Null
+	};
+
+	enum class EError : uint8
+	{
+		None,
+		Malformed,
+		TooDeep,	//Nested deeper than FLimits::MaxDepth.
+		TooLong		//An array longer than FLimits::MaxArrayLength was being decoded.
+	};
+
+	/*Hard ceiling on nesting, however high FLimits::MaxDepth is set.*/
+	static constexpr int32 MaxDepth = 63;
+
+	struct FLimits
+	{
+		int32 MaxDepth = FBPJsonReader::MaxDepth;
+		int32 MaxArrayLength = MAX_int32;
+	};
+
+	explicit FBPJsonReader(TConstArrayView<uint8> InData);
+	FBPJsonReader(TConstArrayView<uint8> InData, const FLimits& InLimits);
+
+	/*Type of the next value, without consuming it. None at the end of input or on error.*/
+	EValueType PeekType();
+
+	bool ReadBeginObject();
+	bool ReadBeginArray();
+
+	/*Advances to the next key of the current object. Returns false (consuming the '}') when the object ends.
+	The key points into the source buffer and is only valid for as long as it is.*/
+	bool NextKey(FAnsiStringView& OutKey);
+
+	/*Advances to the next element of the current array. Returns false (consuming the ']') when the array ends.*/
+	bool NextElement();
+
+	bool ReadNumber(double& OutValue);
+	bool ReadInt(int64& OutValue);
+	bool ReadBool(bool& bOutValue);
+	bool ReadNull();
+	bool ReadString(FString& OutValue);
+
+	/*Skips over the next value, whatever it is, including any nested objects/arrays.*/
+	bool SkipValue();
+
+	/*For callers decoding an array: fails the reader with TooLong once the array already holds the maximum number of elements.*/
+	bool CheckArrayLength(int32 Num);
+
+	bool HasError() const { return Error != EError::None; }
+	EError GetError() const { return Error; }
+
+	/*Byte offset the reader has got to, or where it failed if HasError().*/
+	int32 GetOffset() const { return Pos; }
+
+private:
+
+	const uint8* Data;
+	int32 Size;
+	int32 Pos = 0;
+	int32 Depth = 0;
+
+	//One bit per nesting level, set once the scope has had its first entry and needs a comma before the next.
+	uint64 CommaMask = 0;
+
+	FLimits Limits;
+	EError Error = EError::None;
+
+	bool Fail(EError Reason = EError::Malformed);
+	void SkipWhitespace();
+	bool OpenScope();
+	void CloseScope();
+	bool ConsumeSeparator();
+
+	bool ScanString(int32& OutStart, int32& OutEnd, bool& bOutHasEscapes);
+	bool ScanNumber(int32& OutStart, int32& OutEnd, bool& bOutIsInteger);
+	bool ScanLiteral(const ANSICHAR* Literal, int32 Len);
+};
@@ -0,0 +1,85 @@
+// Copyright d/Dev 2026
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+//Where a fixed-width value was written, so it can be overwritten in place later. See FBPJsonWriter::AddSlot.
+struct FBPJsonSlot
+{
+	int32 Offset = INDEX_NONE;
+	int32 Width = 0;
+	bool bIsInteger = false;
+
+	bool IsValid() const { return Offset != INDEX_NONE; }
+};
+
+/** Single-pass JSON writer for messages going out to Intiface.
+* Appends UTF-8 directly into a caller-owned byte buffer, so a buffer kept around between sends
+* never has to be reallocated once it has grown to fit the largest message.
+* Keys are expected to be plain ASCII literals (they are our own field names), values are escaped.
+*/
+class BUTTPLUGUE_API FBPJsonWriter
+{
+public:
+
+	explicit FBPJsonWriter(TArray<uint8>& InBuffer);
+
+	void BeginObject();
+	void EndObject();
+	void BeginArray();
+	void EndArray();
+
+	void WriteKey(const ANSICHAR* Key);
+
+	void WriteInt(int64 Value);
+	void WriteDouble(double Value);
+
+	/*As above, but if Source has been registered with AddSlot the value is padded out to a fixed width and its position recorded.*/
+	void WriteInt(int64 Value, const void* Source);
+	void WriteDouble(double Value, const void* Source);
+	void WriteBool(bool bValue);
+	void WriteString(FStringView Value);
+	void WriteNull();
+
+	/*Converts a written buffer back to a FString, for logging only.*/
+	static FString ToDebugString(const TArray<uint8>& InBuffer);
+
+	/*Marks the number stored at Source as a patch slot for the next write of it, which will fill OutSlot.
+	Trailing spaces are valid JSON, so any value that fits the width can later be patched in without moving anything else.*/
+	void AddSlot(const void* Source, FBPJsonSlot& OutSlot);
+
+	/*Overwrites a slot in a buffer written earlier. Values too wide for the slot are clamped (ints) or zeroed (doubles).*/
+	static void PatchInt(TArrayView<uint8> InBuffer, const FBPJsonSlot& Slot, int64 Value);
+	static void PatchDouble(TArrayView<uint8> InBuffer, const FBPJsonSlot& Slot, double Value);
+
+	//Wide enough for any int32, and any double at the precision we write.
+	static constexpr int32 IntSlotWidth = 11;
+	static constexpr int32 DoubleSlotWidth = 24;
+
+private:
+
+	TArray<uint8>& Buffer;
+
+	//Set after any complete value, so the next value/key in the same scope knows to emit a comma.
+	bool bNeedsComma = false;
+
+	struct FPendingSlot
+	{
+		const void* Source;
+		FBPJsonSlot* Slot;
+	};
+	TArray<FPendingSlot, TInlineAllocator<4>> PendingSlots;
+
+	FBPJsonSlot* FindSlot(const void* Source);
+	void AppendPadded(const ANSICHAR* Data, int32 Len, int32 Width, FBPJsonSlot& OutSlot);
+
+	//Format into a caller's stack buffer, returning the length. Shared by the writes and the patches.
+	static int32 FormatInt(int64 Value, ANSICHAR (&OutDigits)[21]);
+	static int32 FormatDouble(double Value, ANSICHAR (&OutDigits)[32]);
+
+	void WriteSeparator();
+	void AppendRaw(const ANSICHAR* Data, int32 Len);
+	void AppendByte(uint8 Byte);
+	void AppendCodepoint(uint32 Codepoint);
+};
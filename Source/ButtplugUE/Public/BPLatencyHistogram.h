@@ -0,0 +1,64 @@
+// Copyright d/Dev 2026
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "BPLatencyHistogram.generated.h"
+
+//Round trip times from a latency histogram, in milliseconds.
+USTRUCT(BlueprintType)
+struct FBPLatencySummary
+{
+	GENERATED_BODY()
+
+	//How many replies were measured.
+	UPROPERTY(BlueprintReadOnly, meta = (Category = "ButtplugUE|Debug"))
+	int32 Count = 0;
+
+	UPROPERTY(BlueprintReadOnly, meta = (Category = "ButtplugUE|Debug"))
+	float P50Ms = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, meta = (Category = "ButtplugUE|Debug"))
+	float P95Ms = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, meta = (Category = "ButtplugUE|Debug"))
+	float P99Ms = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, meta = (Category = "ButtplugUE|Debug"))
+	float MaxMs = 0.0f;
+};
+
+/** Fixed-size log-linear histogram of latencies, in the style of HdrHistogram.
+* Values are kept in microseconds, exact below 16us and within about 6% above that (16 linear buckets per power of two),
+* up to a little over an hour. Recording is a couple of bit operations and an increment, and memory never grows.
+*/
+class BUTTPLUGUE_API FBPLatencyHistogram
+{
+public:
+
+	void Record(double Seconds);
+	void Reset();
+
+	int64 GetCount() const { return Count; }
+	double GetMax() const { return MaxMicros / 1e6; }
+
+	/*The latency at or below which Percentile (0...100) of the recorded values fall, in seconds. 0 if nothing was recorded.*/
+	double GetPercentile(double Percentile) const;
+
+	FBPLatencySummary Summarize() const;
+
+private:
+
+	static constexpr int32 SubBucketBits = 4;
+	static constexpr int32 SubBucketCount = 1 << SubBucketBits;
+	static constexpr int32 BucketCount = SubBucketCount + (32 - SubBucketBits) * SubBucketCount;
+
+	TStaticArray<uint32, BucketCount> Buckets { InPlace, 0 };
+	int64 Count = 0;
+	uint32 MaxMicros = 0;
+
+	static int32 ToBucket(uint32 Micros);
+	static uint32 GetBucketLowest(int32 Bucket);
+	static uint32 GetBucketWidth(int32 Bucket);
+};
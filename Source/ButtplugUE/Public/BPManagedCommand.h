@@ -7,6 +7,7 @@
 #include "Tickable.h"
 
 #include "BPTypes.h"
+#include "BPPacketTemplate.h"
 
 #include "BPManagedCommand.generated.h"
 
@@ -29,7 +30,8 @@ public:
 
 	static UBPManagedCommand* CreateManagedCommand(UObject* Context, FBPDeviceObject TargetDevice, FInstancedStruct InCommand,
 													UCurveFloat* InPattern, float InDurationSeconds, FGuid InId, int32 UpdatesPerSecond = 10);
-	void StopCommand(bool bBroadcastStop = true);
+	/*Stops updating. bStopDevice also sends the device a stop, callers that are about to stop it themselves pass false.*/
+	void StopCommand(bool bBroadcastStop = true, bool bStopDevice = true);
 
 	FBPDeviceObject GetDevice() const;
 
@@ -44,6 +46,16 @@ protected:
 
 	bool bActive = false;
 
+	//The command serialized once up front, each update only patches in the new value and Id.
+	FBPPacketTemplate PacketTemplate;
+
+	//Resolution of the actuator being driven, pattern values are snapped to it before sending.
+	int32 StepCount = -1;
+
+	//The driven value inside Command, kept in step with the template so the subsystem can merge Command with other commands instead.
+	double* DrivenValue = nullptr;
+
+	void CompilePacketTemplate();
 	void UpdateDevice();
 
 	UBPDeviceSubsystem* GetBP() const;
@@ -0,0 +1,79 @@
+// Copyright d/Dev 2026
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <atomic>
+
+#include "BPTypes.h"
+
+class FBPJsonWriter;
+class FBPSerializationPlan;
+
+//Everything we know about one message type, looked up once and shared by the send and receive paths.
+struct FBPMessageTypeInfo
+{
+	EBPMessageType Type = EBPMessageType::MAX;
+	FName Title;
+	TArray<ANSICHAR> TitleKey;	//Null terminated UTF-8 title, for the writer.
+	UScriptStruct* Struct = nullptr;
+	const FBPSerializationPlan* Plan = nullptr;
+};
+
+/** The one place message types are declared.
+* Maps a message's title (as Intiface names it) to its struct, its EBPMessageType dispatch slot and its serialization plan.
+* Built the first time it is used and never modified afterwards, so it is safe to read from any thread.
+* Adding a new message type only needs its struct (with its MessageTitle) declared in BPTypes.h and a Register line in the constructor.
+*/
+class BUTTPLUGUE_API FBPMessageRegistry
+{
+public:
+
+	static const FBPMessageRegistry& Get();
+
+	/*Finds a type by its JSON title. Unknown titles return nullptr and are counted rather than asserting.*/
+	const FBPMessageTypeInfo* FindByTitle(FAnsiStringView Title) const;
+
+	const FBPMessageTypeInfo* FindByStruct(const UScriptStruct* Struct) const;
+
+	const FBPMessageTypeInfo& GetInfo(EBPMessageType Type) const { return Types[(uint8)Type]; }
+
+	/*Compile-time shortcut for the send path, resolved once per message type.*/
+	template<typename T>
+	static const FBPMessageTypeInfo& GetInfo()
+	{
+		static const FBPMessageTypeInfo& Info = *Get().FindByStruct(T::StaticStruct());
+		return Info;
+	}
+
+	/*The DeviceIndex a message is addressed to, or INDEX_NONE for message types that are not about one device.*/
+	template<typename T>
+	static int32 GetDeviceIndex(const T& Message) { return GetDeviceIndexImpl(Message, 0); }
+
+	/*Writes {"Title": {Body}} for a message of the given type.*/
+	static void WriteMessage(FBPJsonWriter& Writer, const FBPMessageTypeInfo& Info, const void* Message);
+
+	/*How many messages with titles we do not recognise have been received.*/
+	int32 GetUnknownTitleCount() const { return UnknownTitleCount.load(std::memory_order_relaxed); }
+
+private:
+
+	TArray<FBPMessageTypeInfo> Types;
+	TMap<FName, EBPMessageType> TitleLookup;
+	TMap<const UScriptStruct*, EBPMessageType> StructLookup;
+
+	mutable std::atomic<int32> UnknownTitleCount { 0 };
+
+	FBPMessageRegistry();
+
+	template<typename T>
+	void Register(EBPMessageType Type);
+
+	void CountUnknownTitle(FAnsiStringView Title) const;
+
+	template<typename T>
+	static auto GetDeviceIndexImpl(const T& Message, int) -> decltype((int32)Message.DeviceIndex) { return Message.DeviceIndex; }
+	template<typename T>
+	static int32 GetDeviceIndexImpl(const T& Message, long) { return INDEX_NONE; }
+};
@@ -0,0 +1,79 @@
+// Copyright d/Dev 2026
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "BPTypes.h"
+
+struct FBPMessageTypeInfo;
+
+//Where one message starts in a packet's bytes, and what it is.
+struct FBPOutboundEntry
+{
+	int32 Start = 0;
+	int32 Id = 0;
+	int32 DeviceIndex = INDEX_NONE;
+	EBPMessageType Type = EBPMessageType::MAX;
+};
+
+/** A finished packet from FBPOutboundQueue. Keeps where each message starts, so a stop can still take stale commands back out
+* of it after it has been handed to the outbound thread.
+*/
+struct BUTTPLUGUE_API FBPOutboundPacket
+{
+	TArray<uint8> Bytes;
+	TArray<FBPOutboundEntry> Entries;
+
+	/*As FBPOutboundQueue::RemoveDeviceCommands. A packet left with no messages is empty and should not be sent.*/
+	void RemoveDeviceCommands(int32 DeviceIndex, TArray<int32>& OutRemovedIds);
+
+	int32 Num() const { return Entries.Num(); }
+
+	/*Empties it, keeping both allocations for reuse.*/
+	void Reset()
+	{
+		Bytes.Reset();
+		Entries.Reset();
+	}
+};
+
+/** Collects outbound messages into one multi-message packet ([{...},{...}]), as the protocol allows,
+* so everything sent in a frame goes out as a single websocket frame instead of one per message.
+* Messages are serialized into the packet as they are added, and finished packets swap buffers with the sender so none are reallocated.
+*/
+class BUTTPLUGUE_API FBPOutboundQueue
+{
+public:
+
+	/*Serializes a message onto the end of the pending packet. Its Id and DeviceIndex are kept so it can be taken back out.*/
+	void Add(const FBPMessageTypeInfo& Info, const void* Message, int32 Id, int32 DeviceIndex);
+
+	/*Appends the message from an already serialized single-message packet, e.g. a packet template.*/
+	void AddPacket(TConstArrayView<uint8> Packet, EBPMessageType Type, int32 Id, int32 DeviceIndex);
+
+	/*Takes pending Scalar/Linear/Rotate commands for a device (or every device, for INDEX_NONE) back out of the packet,
+	adding their Ids to OutRemovedIds. Used when the device is stopped, so they cannot start it again once the stop lands.*/
+	void RemoveDeviceCommands(int32 DeviceIndex, TArray<int32>& OutRemovedIds);
+
+	/*Closes the pending packet and swaps it into OutPacket, keeping OutPacket's old allocations to build the next one in.
+	Returns false, leaving OutPacket alone, if nothing was pending.*/
+	bool Finish(FBPOutboundPacket& OutPacket);
+
+	/*Drops anything pending.*/
+	void Reset();
+
+	int32 Num() const { return Count; }
+	int32 GetPendingBytes() const { return Count > 0 ? Buffer.Num() : 0; }
+
+private:
+
+	TArray<uint8> Buffer;
+	int32 Count = 0;
+
+	//Where each pending message starts in Buffer, and what it is.
+	TArray<FBPOutboundEntry> Entries;
+
+	//Opens the packet for its first message, or separates the next one.
+	void BeginMessage();
+};
@@ -0,0 +1,194 @@
+// Copyright d/Dev 2026
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "Containers/Queue.h"
+
+#include <atomic>
+
+#include "BPTypes.h"
+#include "BPCommandCoalescer.h"
+#include "BPOutboundQueue.h"
+
+class FRunnableThread;
+class FEvent;
+class IWebSocket;
+
+//One actuator value from FBPCommandSubmitter. Type is ScalarCmd, LinearCmd or RotateCmd, or MAX to clear what is pending for the device instead.
+//With Type MAX and a ReadyTime, nothing is cleared, the device is held until then as the game thread has just sent it a command.
+struct FBPSubmittedValue
+{
+	EBPMessageType Type = EBPMessageType::MAX;
+	int32 DeviceIndex = INDEX_NONE;
+	int32 ActuatorIndex = -1;
+	double Value = 0.0;
+	int32 Duration = 0;
+	bool bClockwise = true;
+	FName ActuatorType;
+	double ReadyTime = 0.0;
+};
+
+//An actuator the thread has sent a submitted value to, handed back so the game thread's own sends to it are paced and not skipped as redundant.
+struct FBPSubmittedSend
+{
+	EBPMessageType Type = EBPMessageType::MAX;
+	int32 DeviceIndex = INDEX_NONE;
+	int32 ActuatorIndex = -1;
+	//When the device may next be sent a command.
+	double ReadyTime = 0.0;
+};
+
+/** Hands finished outbound packets to the websocket from a thread of its own, so the copy and framing Send does is not paid
+* for on the game thread. Queueing a packet is one lock-free push from the thread that builds them, and stops can jump the queue.
+* A stop that jumps ahead takes that device's actuator commands out of the packets it overtook, so they cannot start it again after it.
+* Packet buffers come back through a spare list once sent, so once warmed up building a packet does not allocate. Queueing one costs a queue node.
+* It also builds and sends the commands for values pushed through FBPCommandSubmitter, and hands out message Ids, so both can be used off the game thread.
+* Where threads are not available (-nothreading etc.) packets are sent as they are queued instead.
+*/
+class BUTTPLUGUE_API FBPOutboundThread : public FRunnable
+{
+public:
+
+	FBPOutboundThread();
+	virtual ~FBPOutboundThread() override;
+
+	/*Queues a packet to be sent on the current socket (see SetSocket). Only call from the thread that builds packets (the game thread
+	for the subsystem). Packets are numbered and pushed in two steps, so the order a stop relies on only holds with a single producer.*/
+	void Send(FBPOutboundPacket&& Packet);
+
+	/*Queues a packet holding a stop for DeviceIndex (INDEX_NONE for every device) ahead of any still waiting.
+	Actuator commands for the device in packets queued before it are dropped, their Ids come back through TakeDroppedId.
+	Only call from the thread that builds packets, as for Send.*/
+	void SendStop(FBPOutboundPacket&& Packet, int32 DeviceIndex);
+
+	/*An emptied packet that has already been sent to build the next one in, or an empty one if there are none spare yet.
+	Only call from the thread that builds packets.*/
+	FBPOutboundPacket TakeSparePacket();
+
+	/*Ids of commands a stop took out of packets that had already been queued, so were never sent. Only call from the thread that builds packets.*/
+	bool TakeDroppedId(int32& OutId) { return DroppedIds.Dequeue(OutId); }
+
+	/*Blocks until everything queued so far has been handed to its socket, or TimeoutSeconds pass. Returns false on timeout.*/
+	bool WaitUntilSent(double TimeoutSeconds);
+
+	/*Sends what it can of the queue within TimeoutSeconds, drops the rest, and stops the thread.*/
+	void Shutdown(double TimeoutSeconds);
+
+	/*Any thread. The next message Id, 1 to INT32_MAX and then round again, unique across everything that sends.*/
+	int32 AllocateMessageId();
+
+	/*Any thread. Queues one actuator value to be merged and sent. Returns false once the thread has been shut down.*/
+	bool Submit(const FBPSubmittedValue& Value);
+
+	/*Game thread. Drops submitted values for a device (or all of them, for INDEX_NONE) that have not gone out yet, as it is being stopped.*/
+	void ClearSubmitted(int32 DeviceIndex);
+
+	/*Game thread. Holds submitted values for a device until ReadyTime, as the game thread has just sent it a command itself.
+	Does nothing until something has been submitted, so games that never use FBPCommandSubmitter do not pay for it.*/
+	void DelaySubmitted(int32 DeviceIndex, double ReadyTime);
+
+	/*Actuators submitted values were sent to, oldest first. Only call from the thread that builds packets.*/
+	bool TakeSubmittedSend(FBPSubmittedSend& OutSend) { return SubmittedSends.Dequeue(OutSend); }
+
+	/*Game thread. The socket everything goes out on. Waits for a send in progress on the old one, so once it returns the thread
+	is done with it and it can be closed, and the thread's reference to it has been let go of here rather than on the thread.
+	Packets queued for the old socket that have not been sent yet are dropped.*/
+	void SetSocket(TSharedPtr<IWebSocket> Socket);
+
+	/*Game thread. The devices submitted values are paced and snapped to StepCount for.*/
+	void SetDevices(const TMap<int32, FBPDeviceObject>& Devices);
+
+	// FRunnable Begin
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+	// FRunnable End
+
+private:
+
+	struct FPacket
+	{
+		FBPOutboundPacket Packet;
+		//The socket it was queued for, see SetSocket.
+		uint32 SocketGeneration = 0;
+		//Order it was queued in, across both queues, so a stop knows which packets it overtook.
+		uint64 Sequence = 0;
+		//For stops, the device stopped (INDEX_NONE for all of them).
+		int32 StoppedDevice = INDEX_NONE;
+	};
+
+	//A stop that has gone out ahead of packets queued before it.
+	struct FStopBarrier
+	{
+		uint64 Sequence = 0;
+		int32 DeviceIndex = INDEX_NONE;
+	};
+
+	//Pushed only by the thread that builds packets, see Send.
+	TQueue<FPacket, EQueueMode::Spsc> PriorityPackets;
+	TQueue<FPacket, EQueueMode::Spsc> Packets;
+	TQueue<FBPOutboundPacket, EQueueMode::Spsc> SparePackets;
+	TQueue<int32, EQueueMode::Spsc> DroppedIds;
+	std::atomic<uint64> NextSequence { 0 };
+
+	//Only touched by the thread. Stops sent ahead of normal packets still waiting, oldest first.
+	TArray<FStopBarrier> StopBarriers;
+
+	FRunnableThread* Thread = nullptr;
+	FEvent* WorkEvent = nullptr;
+	std::atomic<bool> bStopping { false };
+	std::atomic<double> DrainDeadline { 0.0 };
+
+	//Queued and not yet handed to the socket, for WaitUntilSent.
+	std::atomic<int32> PendingCount { 0 };
+
+	//Sends everything queued, priority packets first. Gives up once the deadline passes if one is set.
+	void SendPending();
+	void SendPacket(FPacket& Packet);
+	void Enqueue(FPacket&& Packet, bool bPriority);
+
+	//Takes commands a stop has already gone out ahead of back out of a normal packet.
+	void ApplyStopBarriers(FPacket& Packet);
+
+	//We are storing and iterating the message Id.
+	//Could use a random int each time, but this way in the case of a bug report
+	//we can see how many messages have been sent, which might tie to how long the
+	//instance has been running. Just another data point which might be of use.
+	std::atomic<uint32> MessageIdCounter { 0 };
+
+	//Submitted values, pushed from anywhere and only read by the thread.
+	TQueue<FBPSubmittedValue, EQueueMode::Mpsc> SubmittedValues;
+	//Pushed by the thread as it sends submitted values, for the game thread, see TakeSubmittedSend.
+	TQueue<FBPSubmittedSend, EQueueMode::Spsc> SubmittedSends;
+	//Set by the first Submit, until then the game thread has nothing to tell the thread about its own sends.
+	std::atomic<bool> bHasSubmitted { false };
+
+	//Held by the thread for as long as it is using Socket, so SetSocket can wait for it to finish.
+	FCriticalSection SocketLock;
+	TSharedPtr<IWebSocket> Socket;
+	std::atomic<uint32> SocketGeneration { 0 };
+
+	//Sends on Socket, if it is still the one Generation refers to and is connected.
+	bool SendOnSocket(TConstArrayView<uint8> Bytes, uint32 Generation);
+
+	//What the game thread last published for submitted values, guarded by SharedLock.
+	FCriticalSection SharedLock;
+	TMap<int32, FBPDeviceObject> SharedDevices;
+	std::atomic<bool> bDevicesChanged { false };
+
+	//Only touched by the thread. Submitted values merge per device in the coalescer until the device is ready for another command.
+	FBPCommandCoalescer SubmittedCommands;
+	FBPOutboundQueue SubmittedPacket;
+	FBPOutboundPacket SubmittedBuffer;
+	TMap<int32, FBPDeviceObject> Devices;
+	TMap<int32, double> DeviceReadyTimes;
+	FBPScalarCommand ScratchScalar;
+	FBPLinearCommand ScratchLinear;
+	FBPRotateCommand ScratchRotate;
+
+	//Merges in everything submitted and sends what is ready. Returns how many ms until something held back will be, or MAX_uint32.
+	uint32 SendSubmitted();
+	void ApplySubmitted(const FBPSubmittedValue& Value);
+	int32 GetStepCount(int32 DeviceIndex, TArray<FBPCommandMessage> FBPDeviceMessages::*Actuators, int32 ActuatorIndex) const;
+};
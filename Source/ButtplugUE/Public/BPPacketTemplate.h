@@ -0,0 +1,45 @@
+// Copyright d/Dev 2026
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "BPJsonWriter.h"
+#include "BPMessageRegistry.h"
+
+/** A single-message packet serialized once, with fixed-width slots for the Id and any number of values.
+* For commands that are sent over and over with only a value or two changing (pattern commands),
+* each send is then a few in-place number writes rather than a full reserialization.
+*/
+class BUTTPLUGUE_API FBPPacketTemplate
+{
+public:
+
+	/*Serializes Message, with a value slot for each address in Values, in order. Each must point at a number inside Message.*/
+	template<typename T>
+	void Compile(const T& Message, TConstArrayView<const void*> Values)
+	{
+		Compile(FBPMessageRegistry::GetInfo<T>(), &Message, &Message.Id, Values);
+		DeviceIndex = FBPMessageRegistry::GetDeviceIndex(Message);
+	}
+
+	bool IsCompiled() const { return IdSlot.IsValid(); }
+
+	EBPMessageType GetType() const { return Type; }
+	int32 GetDeviceIndex() const { return DeviceIndex; }
+
+	void SetId(int32 Id);
+	void SetValue(int32 Index, double Value);
+
+	TConstArrayView<uint8> GetBytes() const { return Bytes; }
+
+private:
+
+	TArray<uint8> Bytes;
+	EBPMessageType Type = EBPMessageType::MAX;
+	int32 DeviceIndex = INDEX_NONE;
+	FBPJsonSlot IdSlot;
+	TArray<FBPJsonSlot, TInlineAllocator<2>> ValueSlots;
+
+	void Compile(const FBPMessageTypeInfo& Info, const void* Message, const int32* Id, TConstArrayView<const void*> Values);
+};
@@ -0,0 +1,62 @@
+// Copyright d/Dev 2026
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+
+#include "BPTypes.h"
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#define BP_WITH_COROUTINES 1
+#else
+#define BP_WITH_COROUTINES 0
+#endif
+
+#if BP_WITH_COROUTINES
+
+/** Lets a C++20 coroutine wait on one of UBPDeviceSubsystem's *Async requests without blocking:
+*	const FInstancedStruct Response = co_await Subsystem->RequestDeviceListAsync();
+* Responses are handled on the game thread, so that is where the coroutine resumes. It always resumes, with an
+* FBPMessageStatusError in place of the response if the request timed out or the connection closed.
+* Only the awaiting side is provided, the coroutine's own return type is up to the caller.
+*/
+class FBPResponseAwaitable
+{
+public:
+
+	explicit FBPResponseAwaitable(TFuture<FInstancedStruct>&& InFuture)
+		: Future(MoveTemp(InFuture))
+	{
+	}
+
+	bool await_ready() const { return Future.IsReady(); }
+
+	void await_suspend(std::coroutine_handle<> Handle)
+	{
+		//Then() may run the continuation immediately if the response landed in the meantime, which is fine as we touch nothing after it.
+		Future.Then([this, Handle](TFuture<FInstancedStruct> Done)
+		{
+			Result = Done.Get();
+			Handle.resume();
+		});
+	}
+
+	FInstancedStruct await_resume()
+	{
+		return Result.IsSet() ? MoveTemp(Result.GetValue()) : Future.Get();
+	}
+
+private:
+
+	TFuture<FInstancedStruct> Future;
+	TOptional<FInstancedStruct> Result;
+};
+
+inline FBPResponseAwaitable operator co_await(TFuture<FInstancedStruct>&& Future)
+{
+	return FBPResponseAwaitable(MoveTemp(Future));
+}
+
+#endif
@@ -0,0 +1,91 @@
+// Copyright d/Dev 2026
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <atomic>
+
+class FBPJsonWriter;
+class FBPJsonReader;
+class FProperty;
+class UScriptStruct;
+
+/** A flattened description of how to read and write one UScriptStruct as Intiface-style JSON.
+* Built once per struct type from its FProperty layout and cached for the lifetime of the module,
+* so both directions of (de)serialization share the same field list and can never drift apart.
+* Field names in JSON are the UPROPERTY names, which already match the Buttplug spec.
+* FName fields (actuator and sensor types) are only read as names the protocol defines, so a server cannot grow the name table.
+*/
+class BUTTPLUGUE_API FBPSerializationPlan
+{
+public:
+
+	/*Gets (building on first use) the plan for the given struct type. Safe to call from any thread.*/
+	static const FBPSerializationPlan& Get(const UScriptStruct* Struct);
+
+	/*Writes the struct at Data as a JSON object.*/
+	void Write(FBPJsonWriter& Writer, const void* Data) const;
+
+	/*Fills the struct at Data from the JSON object the reader is sitting on.
+	Fields missing from the JSON keep their current value, unknown ones are skipped. Returns false if the JSON was malformed,
+	or was not an object at all (it is skipped over).*/
+	bool Read(FBPJsonReader& Reader, void* Data) const;
+
+	const UScriptStruct* GetStruct() const { return Struct; }
+
+	/*How FName values are read: String as a name, kept as it is. Names not yet in the name table are only added to it until a
+	fixed number of them have been, after that they read as None. So a server cannot grow the table by sending a new string every time.*/
+	static FName ReadName(const FString& String);
+
+	/*How many FName values read were refused a place in the name table, see ReadName, and were read as None instead.*/
+	static int32 GetRefusedNameCount() { return RefusedNameCount.load(std::memory_order_relaxed); }
+
+private:
+
+	enum class EValueKind : uint8
+	{
+		Int32,
+		Double,
+		Float,
+		Integer,	//Any other integer property, handled through FNumericProperty.
+		Enum,
+		Bool,
+		String,
+		Name,
+		Struct,
+		Array
+	};
+
+	//How to handle a single value, either a struct member or an array element.
+	struct FValuePlan
+	{
+		EValueKind Kind = EValueKind::Int32;
+		const FProperty* Property = nullptr;
+		const FBPSerializationPlan* StructPlan = nullptr;
+		TUniquePtr<FValuePlan> Inner;
+	};
+
+	struct FFieldPlan
+	{
+		FString Name;
+		TArray<ANSICHAR> Key;	//Null terminated UTF-8 copy of Name, for the writer.
+		int32 Offset = 0;
+		FValuePlan Value;
+	};
+
+	const UScriptStruct* Struct = nullptr;
+	TArray<FFieldPlan> Fields;
+
+	static std::atomic<int32> RefusedNameCount;
+
+	explicit FBPSerializationPlan(const UScriptStruct* InStruct);
+
+	static const FBPSerializationPlan& FindOrBuild(const UScriptStruct* InStruct);
+	static bool BuildValuePlan(const FProperty* Property, FValuePlan& OutPlan);
+
+	static void WriteValue(FBPJsonWriter& Writer, const FValuePlan& Plan, const void* ValuePtr);
+	static void ReadValue(FBPJsonReader& Reader, const FValuePlan& Plan, void* ValuePtr);
+
+	const FFieldPlan* FindField(FAnsiStringView Key, int32& InOutHint) const;
+};
@@ -0,0 +1,78 @@
+// Copyright d/Dev 2026
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "BPTypes.h"
+
+/** What we last told each actuator of each device to do, so commands that would not change anything can be dropped.
+* Values are compared after quantization to the actuator's StepCount, so they only match if the device would really do the same thing.
+* Entries are written when a command is sent and confirmed when Intiface answers it with Ok. An Error forgets them,
+* and so does going unconfirmed for too long, so the next command for those actuators always goes out. Optionally, a matching value is still resent every RefreshSeconds.
+*/
+class BUTTPLUGUE_API FBPShadowState
+{
+public:
+
+	/*How often an unchanged value is sent again anyway, 0 to never resend it.*/
+	void SetRefreshSeconds(double InRefreshSeconds) { RefreshSeconds = InRefreshSeconds; }
+
+	/*How long a value Intiface has not confirmed yet is trusted for, after that it is sent again.*/
+	void SetUnconfirmedTimeout(double InSeconds) { UnconfirmedTimeout = InSeconds; }
+
+	/*Strips the actuators whose value matches what was last sent. Returns false if nothing is left to send.*/
+	bool RemoveRedundant(FBPScalarCommand& Command) const;
+	bool RemoveRedundant(FBPLinearCommand& Command) const;
+	bool RemoveRedundant(FBPRotateCommand& Command) const;
+
+	/*Whether sending this command would change nothing at all. False for anything other than Scalar, Linear and Rotate commands.*/
+	bool IsRedundant(const FInstancedStruct& Command) const;
+
+	/*Records the values in a command that has just been sent with this Id.*/
+	void RecordSent(const FBPScalarCommand& Command, int32 Id);
+	void RecordSent(const FBPLinearCommand& Command, int32 Id);
+	void RecordSent(const FBPRotateCommand& Command, int32 Id);
+	void RecordSent(const FInstancedStruct& Command, int32 Id);
+
+	/*Intiface answered the command with this Id, with Ok (bSucceeded) or Error.*/
+	void OnReply(int32 Id, bool bSucceeded);
+
+	/*Forgets one device, e.g. once it has been stopped or removed.*/
+	void RemoveDevice(int32 DeviceIndex);
+
+	/*Forgets one actuator, e.g. because something else has sent it a value since.*/
+	void RemoveActuator(int32 DeviceIndex, EBPMessageType Type, int32 ActuatorIndex) { Actuators.Remove(MakeKey(DeviceIndex, Type, ActuatorIndex)); }
+
+	void Reset() { Actuators.Reset(); }
+
+private:
+
+	struct FActuatorState
+	{
+		double Value = 0.0;
+		double Extra = 0.0;		//Duration for linear actuators, direction for rotating ones.
+		double SentAt = 0.0;
+		int32 Id = 0;
+		bool bConfirmed = false;
+	};
+
+	//Keyed by device, command type and actuator index, packed together. There are only ever a few dozen entries.
+	TMap<uint64, FActuatorState> Actuators;
+	double RefreshSeconds = 0.0;
+	double UnconfirmedTimeout = 10.0;
+
+	static uint64 MakeKey(int32 DeviceIndex, EBPMessageType Type, int32 ActuatorIndex);
+
+	template<typename CommandType, typename ElementType>
+	bool RemoveRedundantImpl(CommandType& Command, TArray<ElementType> CommandType::*Elements) const;
+
+	template<typename CommandType, typename ElementType>
+	bool IsRedundantImpl(const CommandType& Command, TArray<ElementType> CommandType::*Elements) const;
+
+	template<typename CommandType, typename ElementType>
+	void RecordSentImpl(const CommandType& Command, TArray<ElementType> CommandType::*Elements, int32 Id);
+
+	template<typename CommandType, typename ElementType>
+	bool Matches(const CommandType& Command, const ElementType& Element, double Now) const;
+};
@@ -0,0 +1,66 @@
+// Copyright d/Dev 2026
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <atomic>
+
+/** Fixed-capacity ring between exactly one producer thread and one consumer thread, with no locks.
+* Slots are allocated once up front and filled in place, so elements (and whatever allocations they keep) are reused.
+* The producer fills the slot from BeginPush() and publishes it with EndPush(), the consumer reads Peek() and releases it with Pop().
+*/
+template<typename ElementType, int32 Capacity>
+class TBPSpscRing
+{
+	static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two.");
+
+public:
+
+	TBPSpscRing()
+	{
+		Slots.SetNum(Capacity);
+	}
+
+	/*Producer only. The slot to fill with the next element, or nullptr if the ring is full.*/
+	ElementType* BeginPush()
+	{
+		const uint32 Tail = TailIndex.load(std::memory_order_relaxed);
+		if (Tail - HeadIndex.load(std::memory_order_acquire) == (uint32)Capacity)
+		{
+			return nullptr;
+		}
+		return &Slots[Tail & (Capacity - 1)];
+	}
+
+	/*Producer only. Hands the slot from BeginPush() to the consumer.*/
+	void EndPush()
+	{
+		TailIndex.store(TailIndex.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	/*Consumer only. The oldest element, or nullptr if the ring is empty.*/
+	ElementType* Peek()
+	{
+		const uint32 Head = HeadIndex.load(std::memory_order_relaxed);
+		if (Head == TailIndex.load(std::memory_order_acquire))
+		{
+			return nullptr;
+		}
+		return &Slots[Head & (Capacity - 1)];
+	}
+
+	/*Consumer only. Gives the slot from Peek() back to the producer.*/
+	void Pop()
+	{
+		HeadIndex.store(HeadIndex.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+private:
+
+	TArray<ElementType> Slots;
+
+	//On their own cache lines, so the two threads are not fighting over one.
+	alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint32> HeadIndex { 0 };
+	alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint32> TailIndex { 0 };
+};
@@ -0,0 +1,31 @@
+// Copyright d/Dev 2026
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+/* Stat declarations for the plugin, view them in-game with "stat ButtplugUE".
+* Useful for keeping an eye on how much the Intiface traffic is costing per frame.
+*/
+
+DECLARE_STATS_GROUP(TEXT("ButtplugUE"), STATGROUP_ButtplugUE, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Serialize Outbound"), STAT_BPSerializeOutbound, STATGROUP_ButtplugUE, BUTTPLUGUE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Outbound Messages"), STAT_BPOutboundMessages, STATGROUP_ButtplugUE, BUTTPLUGUE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Outbound Bytes"), STAT_BPOutboundBytes, STATGROUP_ButtplugUE, BUTTPLUGUE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Outbound Packets"), STAT_BPOutboundPackets, STATGROUP_ButtplugUE, BUTTPLUGUE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Coalesced Commands"), STAT_BPCoalescedCommands, STATGROUP_ButtplugUE, BUTTPLUGUE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Suppressed Commands"), STAT_BPSuppressedCommands, STATGROUP_ButtplugUE, BUTTPLUGUE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Rate Limited Commands"), STAT_BPRateLimitedCommands, STATGROUP_ButtplugUE, BUTTPLUGUE_API);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Deserialize Inbound"), STAT_BPDeserializeInbound, STATGROUP_ButtplugUE, BUTTPLUGUE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Inbound Messages"), STAT_BPInboundMessages, STATGROUP_ButtplugUE, BUTTPLUGUE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Inbound Bytes"), STAT_BPInboundBytes, STATGROUP_ButtplugUE, BUTTPLUGUE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Unknown Messages"), STAT_BPUnknownMessages, STATGROUP_ButtplugUE, BUTTPLUGUE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Refused Names"), STAT_BPRefusedNames, STATGROUP_ButtplugUE, BUTTPLUGUE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Skipped Messages"), STAT_BPSkippedMessages, STATGROUP_ButtplugUE, BUTTPLUGUE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Rejected Packets"), STAT_BPRejectedPackets, STATGROUP_ButtplugUE, BUTTPLUGUE_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Query Cache Hits"), STAT_BPQueryCacheHits, STATGROUP_ButtplugUE, BUTTPLUGUE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Query Shared In Flight"), STAT_BPQueryShared, STATGROUP_ButtplugUE, BUTTPLUGUE_API);
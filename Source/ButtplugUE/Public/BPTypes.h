@@ -17,13 +17,15 @@
 #include "Engine/DataTable.h"
 
 #include "BPLogging.h"
+#include "BPJsonWriter.h"
 
 #include "BPTypes.generated.h"
 
 /** This class contains all the declarations for enums and structs
 * They are used to communicate with Intiface Central, handling serialization of JSON messages in both directions.
-* Intiface's JSON structure is a little different to how Unreal handles it, so we are manually declaring our own Serialization method
-* via the virtual ToString() function.
+* Intiface's JSON structure is a little different to how Unreal handles it, so rather than FJsonObjectConverter we use
+* FBPSerializationPlan, which is built once per struct from its UPROPERTYs and drives both encoding and decoding.
+* Any UPROPERTY on a message struct is therefore part of its JSON, named exactly as declared.
 */
 
 //Error types that can come from Intiface.
@@ -38,6 +40,27 @@ enum class EBPErrorCode : uint8
 	MAX						UMETA(Hidden)
 };
 
+//Why an inbound packet from Intiface was rejected, see ButtplugUESettings for the limits.
+UENUM(BlueprintType)
+enum class EBPInboundRejectReason : uint8
+{
+	None		UMETA(Tooltip = "The packet was accepted."),
+	TooLarge	UMETA(Tooltip = "The packet was bigger than MaxInboundPacketBytes."),
+	TooDeep		UMETA(Tooltip = "The JSON was nested deeper than MaxInboundDepth."),
+	TooLong		UMETA(Tooltip = "An array had more than MaxInboundArrayLength elements."),
+	Malformed	UMETA(Tooltip = "The packet was not valid JSON, or not shaped like an Intiface message."),
+	MAX			UMETA(Hidden)
+};
+
+//When messages queued for Intiface are actually sent, see ButtplugUESettings.
+UENUM(BlueprintType)
+enum class EBPOutboundFlushMode : uint8
+{
+	Immediate		UMETA(Tooltip = "Every message is sent on its own as soon as it is issued."),
+	PostActorTick	UMETA(Tooltip = "Messages are batched and sent once the world has finished ticking actors."),
+	EndOfFrame		UMETA(Tooltip = "Messages are batched and sent at the very end of the frame.")
+};
+
 UENUM(BlueprintType)
 enum class EBPCommandType : uint8
 {
@@ -47,6 +70,35 @@ enum class EBPCommandType : uint8
 	MAX					UMETA(Hidden)
 };
 
+//Every message type in the protocol, doubling as its slot in FBPMessageRegistry.
+UENUM(BlueprintType)
+enum class EBPMessageType : uint8
+{
+	Ok						UMETA(Tooltip = "Server acknowledging a message."),
+	Error					UMETA(Tooltip = "Server reporting an error for a message."),
+	Ping					UMETA(Tooltip = "Client heartbeat."),
+	RequestServerInfo		UMETA(Tooltip = "Client handshake."),
+	ServerInfo				UMETA(Tooltip = "Server handshake response."),
+	StartScanning			UMETA(Tooltip = "Client asking the server to scan for devices."),
+	StopScanning			UMETA(Tooltip = "Client asking the server to stop scanning."),
+	ScanningFinished		UMETA(Tooltip = "Server reporting scanning has ended."),
+	RequestDeviceList		UMETA(Tooltip = "Client asking for connected devices."),
+	DeviceList				UMETA(Tooltip = "Server listing connected devices."),
+	DeviceAdded				UMETA(Tooltip = "Server reporting a newly connected device."),
+	DeviceRemoved			UMETA(Tooltip = "Server reporting a disconnected device."),
+	StopDeviceCmd			UMETA(Tooltip = "Client stopping one device."),
+	StopAllDevices			UMETA(Tooltip = "Client stopping every device."),
+	ScalarCmd				UMETA(Tooltip = "Client setting scalar actuators."),
+	LinearCmd				UMETA(Tooltip = "Client moving linear actuators."),
+	RotateCmd				UMETA(Tooltip = "Client setting rotating actuators."),
+	SensorMessageBase		UMETA(Hidden),
+	SensorReadCmd			UMETA(Tooltip = "Client reading a sensor."),
+	SensorReading			UMETA(Tooltip = "Server reporting a sensor value."),
+	SensorSubscribeCmd		UMETA(Tooltip = "Client subscribing to a sensor."),
+	SensorUnsubscribeCmd	UMETA(Tooltip = "Client unsubscribing from a sensor."),
+	MAX						UMETA(Hidden)
+};
+
 //Base command message type, which can describe any type of command.
 USTRUCT(Blueprintable, BlueprintType)
 struct FBPCommandMessage : public FTableRowBase
@@ -78,15 +130,6 @@ public:
 		ActuatorType = InActuator;
 	}
 
-	FString ToString() const
-	{
-		FStringFormatNamedArguments Args;
-		Args.Add(TEXT("StepCount"), StepCount);
-		Args.Add(TEXT("FeatureDescriptor"), FeatureDescriptor);
-		Args.Add(TEXT("ActuatorType"), ActuatorType);
-		return FString::Format(TEXT("{\"StepCount\": {StepCount}, \"FeatureDescriptor\": {FeatureDescriptor}, \"ActuatorType\": \"{ActuatorType}\"}"), Args);
-	}
-	
 };
 
 /*Stub structure to denote the existance of a StopDevice command.
@@ -139,50 +182,6 @@ public:
 		StopDeviceCmd = FBPStopDeviceCommand();
 	}
 
-	FString ToString() const
-	{
-		FStringFormatNamedArguments Args;
-
-		FString ScalarCmds = "[";
-		for (int i = 0; i < ScalarCmd.Num(); i++)
-		{
-			ScalarCmds += ScalarCmd[i].ToString();
-			if (i != ScalarCmd.Num() - 1)
-			{
-				ScalarCmds += ",";
-			}
-		}
-		ScalarCmds += "]";
-
-		FString LinearCmds = "[";
-		for (int i = 0; i < LinearCmd.Num(); i++)
-		{
-			LinearCmds += LinearCmd[i].ToString();
-			if (i != LinearCmd.Num() - 1)
-			{
-				LinearCmds += ",";
-			}
-		}
-		LinearCmds += "]";
-
-		FString RotateCmds = "[";
-		for (int i = 0; i < RotateCmd.Num(); i++)
-		{
-			RotateCmds += RotateCmd[i].ToString();
-			if (i != RotateCmd.Num() - 1)
-			{
-				RotateCmds += ",";
-			}
-		}
-		RotateCmds += "]";
-
-		Args.Add(TEXT("ScalarCmds"), ScalarCmds);
-		Args.Add(TEXT("LinearCmds"), LinearCmds);
-		Args.Add(TEXT("RotateCmds"), RotateCmds);
-
-		return FString::Format(TEXT("{\"ScalarCmd\":{ScalarCmds},\"LinearCmd\":{LinearCmds},\"RotateCmd\":{RotateCmds},\"StopDeviceCmd\":{}}"), Args);
-	}
-
 };
 
 //Definition of a Device as described by Intiface.
@@ -230,18 +229,6 @@ public:
 		DeviceMessages = InDeviceMessages;
 	}
 
-	FString ToString() const
-	{
-		FStringFormatNamedArguments Args;
-		Args.Add(TEXT("DeviceName"), DeviceName);
-		Args.Add(TEXT("DeviceIndex"), DeviceIndex);
-		Args.Add(TEXT("DeviceMessageTimingGap"), DeviceMessageTimingGap);
-		Args.Add(TEXT("DeviceDisplayName"), DeviceDisplayName);
-		Args.Add(TEXT("DeviceMessages"), DeviceMessages.ToString());
-
-		return FString::Format(TEXT("{\"DeviceName\": \"{DeviceName}\", \"DeviceIndex\": {DeviceIndex}, \"DeviceMessageTimingGap\": {DeviceMessageTimingGap}, \"DeviceDisplayName\": \"{DeviceDisplayName}\", \"DeviceMessages\": {DeviceMessages}}"), Args);
-	}
-
 	bool operator==(const FBPDeviceObject& Other) const
 	{
 		return DeviceIndex == Other.DeviceIndex;
@@ -284,15 +271,6 @@ public:
 		Scalar = InScalar;
 		ActuatorType = InAcuatorType;
 	}
-
-	FString ToString() const
-	{
-		FStringFormatNamedArguments Args;
-		Args.Add(TEXT("Index"), Index);
-		Args.Add(TEXT("Scalar"), Scalar);
-		Args.Add(TEXT("ActuatorType"), ActuatorType);
-		return FString::Format(TEXT("{\"Index\": {Index}, \"Scalar\": {Scalar}, \"ActuatorType\": \"{ActuatorType}\"}"), Args);
-	}
 };
 
 //Definition of a Linear component of a device.
@@ -325,15 +303,6 @@ public:
 		Duration = InDuration;
 		Position = InPosition;
 	}
-
-	FString ToString() const
-	{
-		FStringFormatNamedArguments Args;
-		Args.Add(TEXT("Index"), Index);
-		Args.Add(TEXT("Duration"), Duration);
-		Args.Add(TEXT("Position"), Position);
-		return FString::Format(TEXT("{\"Index\": {Index}, \"Duration\": {Duration}, \"Position\": {Position}}"), Args);
-	}
 };
 
 //Definition of a Rotate component of a device.
@@ -366,19 +335,11 @@ public:
 		Speed = InSpeed;
 		Clockwise = InClockwise;
 	}
-
-	FString ToString() const
-	{
-		FStringFormatNamedArguments Args;
-		Args.Add(TEXT("Index"), Index);
-		Args.Add(TEXT("Speed"), Speed);
-		Args.Add(TEXT("Clockwise"), Clockwise);
-		return FString::Format(TEXT("{\"Index\": {Index}, \"Speed\": {Speed}, \"Clockwise\": \"{Clockwise}\"}"), Args);
-	}
 };
 
 /*Base class for all Message structs
-* Contains Id and Message title to align with Intiface's way of serializing messages.
+* Contains Id to align with Intiface's way of serializing messages.
+* Each message type declares its title as a static MessageTitle constant, rather than every instance carrying a copy.
 */
 USTRUCT(Blueprintable, BlueprintType)
 struct FBPMessageBase
@@ -387,31 +348,21 @@ struct FBPMessageBase
 
 public:
 
-	FString MessageTitle;
-
 	UPROPERTY()
 	int32 Id;
 
 	FBPMessageBase()
 	{
-		MessageTitle = "";
 		Id = -1;
 	}
 
-	FBPMessageBase(FString InMessageTitle, int32 InId)
-	{	
-		MessageTitle = InMessageTitle;
+	FBPMessageBase(int32 InId)
+	{
 		Id = InId;
 	}
 
 	virtual ~FBPMessageBase() = default;
 
-	//This is where we define serialization for this and any child struct.
-	virtual FString ToString() const
-	{
-		return "{BaseType}";
-	}
-
 	virtual int32 GetId() const
 	{
 		return Id;
@@ -442,25 +393,15 @@ public:
 		Messages = InMessages;
 	}
 
+	//Serializes the whole packet into OutBuffer, appending to whatever is already there.
+	void Serialize(TArray<uint8>& OutBuffer) const;
+
+	//Debug/logging helper.
 	FString ToString() const
 	{
-		FString Out = "[";
-
-		for (int32 i = 0; i < Messages.Num(); i++)
-		{
-			Out += "{\"";
-			Out += Messages[i].GetPtr<FBPMessageBase>()->MessageTitle;
-			Out += "\":";
-			Out += Messages[i].GetPtr<FBPMessageBase>()->ToString();
-			Out += "}";
-			if (i != Messages.Num() - 1)
-			{
-				Out += ",";
-			}
-		}
-
-		Out += "]";
-		return Out;
+		TArray<uint8> Buffer;
+		Serialize(Buffer);
+		return FBPJsonWriter::ToDebugString(Buffer);
 	}
 
 };
@@ -473,27 +414,20 @@ struct FBPMessageStatusOk : public FBPMessageBase
 
 public:
 
+	static constexpr const ANSICHAR* MessageTitle = "Ok";
+
 	FBPMessageStatusOk()
 	{
-		MessageTitle = "Ok";
 		Id = -1;
 	}
 
 	FBPMessageStatusOk(int32 InId)
 	{
-		MessageTitle = "Ok";
 		Id = InId;
 	}
 
 	virtual ~FBPMessageStatusOk() = default;
 
-	virtual FString ToString() const override
-	{
-		FStringFormatNamedArguments Args;
-		Args.Add(TEXT("Id"), Id);
-		return FString::Format(TEXT("{\"Id\": {Id}}"), Args);
-	}
-
 };
 
 //Definition for "Error" message from Server.
@@ -504,6 +438,8 @@ struct FBPMessageStatusError : public FBPMessageBase
 
 public:
 
+	static constexpr const ANSICHAR* MessageTitle = "Error";
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Meta = (Category = "ButtplugUE|Types"))
 		FString ErrorMessage;
 
@@ -512,7 +448,6 @@ public:
 
 	FBPMessageStatusError()
 	{
-		MessageTitle = "Error";
 		Id = -1;
 		ErrorMessage = "None";
 		ErrorCode = EBPErrorCode::ERROR_UNKNOWN;
@@ -520,7 +455,6 @@ public:
 
 	FBPMessageStatusError(int32 InId, FString InErrorMessage, EBPErrorCode InErrorCode)
 	{
-		MessageTitle = "Error";
 		Id = InId;
 		ErrorMessage = InErrorMessage;
 		ErrorCode = InErrorCode;
@@ -528,15 +462,6 @@ public:
 
 	virtual ~FBPMessageStatusError() = default;
 
-	virtual FString ToString() const override
-	{
-		FStringFormatNamedArguments Args;
-		Args.Add(TEXT("Id"), Id);
-		Args.Add(TEXT("ErrorMessage"), ErrorMessage);
-		Args.Add(TEXT("ErrorCode"), (uint8)ErrorCode);
-		return FString::Format(TEXT("{\"Id\": {Id}, \"ErrorMessage\": \"{ErrorMessage}\", \"ErrorCode\": {ErrorCode}}"), Args);
-	}
-
 };
 
 //Definition for simple Ping message to Server.
@@ -547,27 +472,20 @@ struct FBPMessageStatusPing : public FBPMessageBase
 
 public:
 
+	static constexpr const ANSICHAR* MessageTitle = "Ping";
+
 	FBPMessageStatusPing()
 	{
-		MessageTitle = "Ping";
 		Id = -1;
 	}
 
 	FBPMessageStatusPing(int32 InId)
 	{
-		MessageTitle = "Ping";
 		Id = InId;
 	}
 
 	virtual ~FBPMessageStatusPing() = default;
 
-	virtual FString ToString() const override
-	{
-		FStringFormatNamedArguments Args;
-		Args.Add(TEXT("Id"), Id);
-		return FString::Format(TEXT("{\"Id\": {Id}}"), Args);
-	}
-
 };
 
 //Definition for Server info Request to Server.
@@ -578,6 +496,8 @@ struct FBPMessageRequestServerInfo : public FBPMessageBase
 
 public:
 
+	static constexpr const ANSICHAR* MessageTitle = "RequestServerInfo";
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Meta = (Category = "ButtplugUE|Types"))
 		FString ClientName;
 
@@ -586,7 +506,6 @@ public:
 
 	FBPMessageRequestServerInfo()
 	{
-		MessageTitle = "RequestServerInfo";
 		Id = -1;
 		ClientName = "None";
 		MessageVersion = -1;
@@ -594,7 +513,6 @@ public:
 
 	FBPMessageRequestServerInfo(int32 InId, FString InClientName, int32 InMessageVersion)
 	{
-		MessageTitle = "RequestServerInfo";
 		Id = InId;
 		ClientName = InClientName;
 		MessageVersion = InMessageVersion;
@@ -602,15 +520,6 @@ public:
 
 	virtual ~FBPMessageRequestServerInfo() = default;
 
-	virtual FString ToString() const override
-	{
-		FStringFormatNamedArguments Args;
-		Args.Add(TEXT("Id"), Id);
-		Args.Add(TEXT("ClientName"), ClientName);
-		Args.Add(TEXT("MessageVersion"), MessageVersion);
-		return FString::Format(TEXT("{\"Id\": {Id}, \"ClientName\": \"{ClientName}\", \"MessageVersion\": {MessageVersion}}"), Args);
-	}
-
 };
 
 //Definition of Server Info message from Server.
@@ -621,6 +530,8 @@ struct FBPMessageServerInfo : public FBPMessageBase
 
 public:
 
+	static constexpr const ANSICHAR* MessageTitle = "ServerInfo";
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Meta = (Category = "ButtplugUE|Types"))
 		FString ServerName;
 
@@ -632,7 +543,6 @@ public:
 
 	FBPMessageServerInfo()
 	{
-		MessageTitle = "ServerInfo";
 		Id = -1;
 		ServerName = "None";
 		MessageVersion = -1;
@@ -641,7 +551,6 @@ public:
 
 	FBPMessageServerInfo(int32 InId, FString InServerName, int32 InMessageVersion, int32 InMaxPingTime)
 	{
-		MessageTitle = "ServerInfo";
 		Id = InId;
 		ServerName = InServerName;
 		MessageVersion = InMessageVersion;
@@ -650,16 +559,6 @@ public:
 
 	virtual ~FBPMessageServerInfo() = default;
 
-	virtual FString ToString() const override
-	{
-		FStringFormatNamedArguments Args;
-		Args.Add(TEXT("Id"), Id);
-		Args.Add(TEXT("ServerName"), ServerName);
-		Args.Add(TEXT("MessageVersion"), MessageVersion);
-		Args.Add(TEXT("MaxPingTime"), MaxPingTime);
-		return FString::Format(TEXT("{\"Id\": {Id}, \"ServerName\": \"{ServerName}\", \"MessageVersion\": {MessageVersion}, \"MaxPingTime\": {MaxPingTime}}"), Args);
-	}
-
 	static FBPMessageServerInfo FromString(const FString& Source)
 	{
 		FBPMessageServerInfo* Out = new FBPMessageServerInfo();
@@ -677,26 +576,19 @@ struct FBPStartScanning : public FBPMessageBase
 
 public:
 
+	static constexpr const ANSICHAR* MessageTitle = "StartScanning";
+
 	FBPStartScanning()
 	{
-		MessageTitle = "StartScanning";
 		Id = -1;
 	}
 
 	FBPStartScanning(int32 InId)
 	{
-		MessageTitle = "StartScanning";
 		Id = InId;
 	}
 
 	virtual ~FBPStartScanning() = default;
-
-	virtual FString ToString() const override
-	{
-		FStringFormatNamedArguments Args;
-		Args.Add(TEXT("Id"), Id);
-		return FString::Format(TEXT("{\"Id\": {Id}}"), Args);
-	}
 };
 
 //Definition of Stop Scanning command to Server
@@ -707,26 +599,19 @@ struct FBPStopScanning : public FBPMessageBase
 
 public:
 
+	static constexpr const ANSICHAR* MessageTitle = "StopScanning";
+
 	FBPStopScanning()
 	{
-		MessageTitle = "StopScanning";
 		Id = -1;
 	}
 
 	FBPStopScanning(int32 InId)
 	{
-		MessageTitle = "StopScanning";
 		Id = InId;
 	}
 
 	virtual ~FBPStopScanning() = default;
-
-	virtual FString ToString() const override
-	{
-		FStringFormatNamedArguments Args;
-		Args.Add(TEXT("Id"), Id);
-		return FString::Format(TEXT("{\"Id\": {Id}}"), Args);
-	}
 };
 
 //Definition of Scanning Finished message from Server.
@@ -737,26 +622,19 @@ struct FBPScanningFinished : public FBPMessageBase
 
 public:
 
+	static constexpr const ANSICHAR* MessageTitle = "ScanningFinished";
+
 	FBPScanningFinished()
 	{
-		MessageTitle = "ScanningFinished";
 		Id = -1;
 	}
 
 	FBPScanningFinished(int32 InId)
 	{
-		MessageTitle = "ScanningFinished";
 		Id = InId;
 	}
 
 	virtual ~FBPScanningFinished() = default;
-
-	virtual FString ToString() const override
-	{
-		FStringFormatNamedArguments Args;
-		Args.Add(TEXT("Id"), Id);
-		return FString::Format(TEXT("{\"Id\": {Id}}"), Args);
-	}
 };
 
 //Definition of RequestDeviceList request to Server.
@@ -767,26 +645,19 @@ struct FBPRequestDeviceList : public FBPMessageBase
 
 public:
 
+	static constexpr const ANSICHAR* MessageTitle = "RequestDeviceList";
+
 	FBPRequestDeviceList()
 	{
-		MessageTitle = "RequestDeviceList";
 		Id = -1;
 	}
 
 	FBPRequestDeviceList(int32 InId)
 	{
-		MessageTitle = "RequestDeviceList";
 		Id = InId;
 	}
 
 	virtual ~FBPRequestDeviceList() = default;
-
-	virtual FString ToString() const override
-	{
-		FStringFormatNamedArguments Args;
-		Args.Add(TEXT("Id"), Id);
-		return FString::Format(TEXT("{\"Id\": {Id}}"), Args);
-	}
 };
 
 //Definition of DeviceList message from Server.
@@ -797,46 +668,25 @@ struct FBPDeviceList : public FBPMessageBase
 
 public:
 
+	static constexpr const ANSICHAR* MessageTitle = "DeviceList";
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Meta = (Category = "ButtplugUE|Types"))
 		TArray<FBPDeviceObject> Devices;
 
 	FBPDeviceList()
 	{
-		MessageTitle = "DeviceList";
 		Id = -1;
 		Devices = TArray<FBPDeviceObject>();
 	}
 
 	FBPDeviceList(int32 InId, TArray<FBPDeviceObject> InDevices)
 	{
-		MessageTitle = "DeviceList";
 		Id = InId;
 		Devices = InDevices;
 	}
 
 	virtual ~FBPDeviceList() = default;
 
-	virtual FString ToString() const override
-	{
-		FStringFormatNamedArguments Args;
-		Args.Add(TEXT("Id"), Id);
-		
-		FString DevicesString = "[";
-		for (int i = 0; i < Devices.Num(); i++)
-		{
-			DevicesString += Devices[i].ToString();
-			if (i != Devices.Num() - 1)
-			{
-				DevicesString += ",";
-			}
-		}
-		DevicesString += "]";
-
-		Args.Add(TEXT("Devices"), DevicesString);
-
-		return FString::Format(TEXT("{\"Id\": {Id}, \"Devices\": {Devices}}"), Args);
-	}
-
 };
 
 //Definition of DeviceAdded message from Server.
@@ -847,32 +697,25 @@ struct FBPDeviceAdded : public FBPMessageBase
 
 public:
 
+	static constexpr const ANSICHAR* MessageTitle = "DeviceAdded";
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Meta = (Category = "ButtplugUE|Types"))
 		FBPDeviceObject Device;
 
 	FBPDeviceAdded()
 	{
-		MessageTitle = "DeviceAdded";
 		Id = -1;
 		Device = FBPDeviceObject();
 	}
 
 	FBPDeviceAdded(int32 InId, FBPDeviceObject InDevice)
 	{
-		MessageTitle = "DeviceAdded";
 		Id = InId;
 		Device = InDevice;
 	}
 
 	virtual ~FBPDeviceAdded() = default;
 
-	virtual FString ToString() const override
-	{
-		FStringFormatNamedArguments Args;
-		Args.Add(TEXT("Id"), Id);
-		Args.Add(TEXT("Devices"), Device.ToString());
-		return FString::Format(TEXT("{\"Id\": {Id}, {Device}}"), Args);
-	}
 };
 
 //Definition of DeviceRemoved message from Server.
@@ -883,32 +726,25 @@ struct FBPDeviceRemove : public FBPMessageBase
 
 public:
 
+	static constexpr const ANSICHAR* MessageTitle = "DeviceRemoved";
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Meta = (Category = "ButtplugUE|Types"))
 		int32 DeviceIndex;
 
 	FBPDeviceRemove()
 	{
-		MessageTitle = "DeviceRemoved";
 		Id = -1;
 		DeviceIndex = -1;
 	}
 
 	FBPDeviceRemove(int32 InId, int32 InDeviceIndex)
 	{
-		MessageTitle = "DeviceRemoved";
 		Id = InId;
 		DeviceIndex = InDeviceIndex;
 	}
 
 	virtual ~FBPDeviceRemove() = default;
 
-	virtual FString ToString() const override
-	{
-		FStringFormatNamedArguments Args;
-		Args.Add(TEXT("Id"), Id);
-		Args.Add(TEXT("DeviceIndex"), DeviceIndex);
-		return FString::Format(TEXT("{\"Id\": {Id}, \"DeviceIndex\": {DeviceIndex}}"), Args);
-	}
 };
 
 //Definition of StopDevice command to Server.
@@ -919,32 +755,25 @@ struct FBPStopDeviceCmd : public FBPMessageBase
 
 public:
 
+	static constexpr const ANSICHAR* MessageTitle = "StopDeviceCmd";
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Meta = (Category = "ButtplugUE|Types"))
 		int32 DeviceIndex;
 
 	FBPStopDeviceCmd()
 	{
-		MessageTitle = "StopDeviceCmd";
 		Id = -1;
 		DeviceIndex = -1;
 	}
 
 	FBPStopDeviceCmd(int32 InId, int32 InDeviceIndex)
 	{
-		MessageTitle = "StopDeviceCmd";
 		Id = InId;
 		DeviceIndex = InDeviceIndex;
 	}
 
 	virtual ~FBPStopDeviceCmd() = default;
 
-	virtual FString ToString() const override
-	{
-		FStringFormatNamedArguments Args;
-		Args.Add(TEXT("Id"), Id);
-		Args.Add(TEXT("DeviceIndex"), DeviceIndex);
-		return FString::Format(TEXT("{\"Id\": {Id}, \"DeviceIndex\": {DeviceIndex}}"), Args);
-	}
 };
 
 //Definition of StopAllDevices command to Server.
@@ -955,26 +784,19 @@ struct FBPStopAllDevices : public FBPMessageBase
 
 public:
 
+	static constexpr const ANSICHAR* MessageTitle = "StopAllDevices";
+
 	FBPStopAllDevices()
 	{
-		MessageTitle = "StopAllDevices";
 		Id = -1;
 	}
 
 	FBPStopAllDevices(int32 InId)
 	{
-		MessageTitle = "StopAllDevices";
 		Id = InId;
 	}
 
 	virtual ~FBPStopAllDevices() = default;
-
-	virtual FString ToString() const override
-	{
-		FStringFormatNamedArguments Args;
-		Args.Add(TEXT("Id"), Id);
-		return FString::Format(TEXT("{\"Id\": {Id}}"), Args);
-	}
 };
 
 //Definition of Scalar Command message to Server. Can wrap multiple commands to a single device.
@@ -985,6 +807,8 @@ struct FBPScalarCommand : public FBPMessageBase
 
 public:
 
+	static constexpr const ANSICHAR* MessageTitle = "ScalarCmd";
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Meta = (Category = "ButtplugUE|Types"))
 		int32 DeviceIndex;
 
@@ -993,7 +817,6 @@ public:
 
 	FBPScalarCommand()
 	{
-		MessageTitle = "ScalarCmd";
 		Id = -1;
 		DeviceIndex = -1;
 		Scalars = TArray<FBPScalarObject>();
@@ -1001,7 +824,6 @@ public:
 
 	FBPScalarCommand(int32 InId, int32 InDeviceIndex, TArray<FBPScalarObject> InScalars)
 	{
-		MessageTitle = "ScalarCmd";
 		Id = InId;
 		DeviceIndex = InDeviceIndex;
 		Scalars = InScalars;
@@ -1009,27 +831,6 @@ public:
 
 	virtual ~FBPScalarCommand() = default;
 
-	virtual FString ToString() const override
-	{
-		FStringFormatNamedArguments Args;
-		Args.Add(TEXT("Id"), Id);
-		Args.Add(TEXT("DeviceIndex"), DeviceIndex);
-
-		FString ScalarsString = "[";
-		for (int i = 0; i < Scalars.Num(); i++)
-		{
-			ScalarsString += Scalars[i].ToString();
-			if (i != Scalars.Num() - 1)
-			{
-				ScalarsString += ",";
-			}
-		}
-		ScalarsString += "]";
-
-		Args.Add(TEXT("Scalars"), ScalarsString);
-
-		return FString::Format(TEXT("{\"Id\": {Id}, \"DeviceIndex\": {DeviceIndex}, \"Scalars\": {Scalars}}"), Args);
-	}
 };
 
 //Definition of Linear Command message to Server. Can wrap multiple commands to a single device.
@@ -1040,6 +841,8 @@ struct FBPLinearCommand : public FBPMessageBase
 
 public:
 
+	static constexpr const ANSICHAR* MessageTitle = "LinearCmd";
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Meta = (Category = "ButtplugUE|Types"))
 		int32 DeviceIndex;
 
@@ -1048,7 +851,6 @@ public:
 
 	FBPLinearCommand()
 	{
-		MessageTitle = "LinearCmd";
 		Id = -1;
 		DeviceIndex = -1;
 		Vectors = TArray<FBPLinearObject>();
@@ -1056,7 +858,6 @@ public:
 
 	FBPLinearCommand(int32 InId, int32 InDeviceIndex, TArray<FBPLinearObject> InVectors)
 	{
-		MessageTitle = "LinearCmd";
 		Id = InId;
 		DeviceIndex = InDeviceIndex;
 		Vectors = InVectors;
@@ -1064,27 +865,6 @@ public:
 
 	virtual ~FBPLinearCommand() = default;
 
-	virtual FString ToString() const override
-	{
-		FStringFormatNamedArguments Args;
-		Args.Add(TEXT("Id"), Id);
-		Args.Add(TEXT("DeviceIndex"), DeviceIndex);
-
-		FString VectorsString = "[";
-		for (int i = 0; i < Vectors.Num(); i++)
-		{
-			VectorsString += Vectors[i].ToString();
-			if (i != Vectors.Num() - 1)
-			{
-				VectorsString += ",";
-			}
-		}
-		VectorsString += "]";
-
-		Args.Add(TEXT("Vectors"), VectorsString);
-
-		return FString::Format(TEXT("{\"Id\": {Id}, \"DeviceIndex\": {DeviceIndex}, \"Vectors\": {Vectors}}"), Args);
-	}
 };
 
 //Definition of Rotate Command message to Server. Can wrap multiple commands to a single device.
@@ -1095,6 +875,8 @@ struct FBPRotateCommand : public FBPMessageBase
 
 public:
 
+	static constexpr const ANSICHAR* MessageTitle = "RotateCmd";
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Meta = (Category = "ButtplugUE|Types"))
 		int32 DeviceIndex;
 
@@ -1103,7 +885,6 @@ public:
 
 	FBPRotateCommand()
 	{
-		MessageTitle = "RotateCmd";
 		Id = -1;
 		DeviceIndex = -1;
 		Rotations = TArray<FBPRotateObject>();
@@ -1111,7 +892,6 @@ public:
 
 	FBPRotateCommand(int32 InId, int32 InDeviceIndex, TArray<FBPRotateObject> InRotations)
 	{
-		MessageTitle = "RotateCmd";
 		Id = InId;
 		DeviceIndex = InDeviceIndex;
 		Rotations = InRotations;
@@ -1119,27 +899,6 @@ public:
 
 	virtual ~FBPRotateCommand() = default;
 
-	virtual FString ToString() const override
-	{
-		FStringFormatNamedArguments Args;
-		Args.Add(TEXT("Id"), Id);
-		Args.Add(TEXT("DeviceIndex"), DeviceIndex);
-
-		FString RotatesString = "[";
-		for (int i = 0; i < Rotations.Num(); i++)
-		{
-			RotatesString += Rotations[i].ToString();
-			if (i != Rotations.Num() - 1)
-			{
-				RotatesString += ",";
-			}
-		}
-		RotatesString += "]";
-
-		Args.Add(TEXT("Rotations"), RotatesString);
-
-		return FString::Format(TEXT("{\"Id\": {Id}, \"DeviceIndex\": {DeviceIndex}, \"Rotations\": {Rotations}}"), Args);
-	}
 };
 
 //Base struct type for Sensor Messages to and from Server. Currently unsupported.
@@ -1150,6 +909,8 @@ struct FBPSensorMessageBase : public FBPMessageBase
 
 public:
 
+	static constexpr const ANSICHAR* MessageTitle = "SensorMessageBase";
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Meta = (Category = "ButtplugUE|Types"))
 		int32 DeviceIndex;
 
@@ -1161,7 +922,6 @@ public:
 
 	FBPSensorMessageBase()
 	{
-		MessageTitle = "SensorMessageBase";
 		Id = -1;
 		DeviceIndex = -1;
 		SensorIndex = -1;
@@ -1170,7 +930,6 @@ public:
 
 	FBPSensorMessageBase(int32 InId, int32 InDeviceIndex, int32 InSensorIndex, FString InSensorType)
 	{
-		MessageTitle = "SensorMessageBase";
 		Id = InId;
 		DeviceIndex = InDeviceIndex;
 		SensorIndex = InSensorIndex;
@@ -1179,16 +938,6 @@ public:
 
 	virtual ~FBPSensorMessageBase() = default;
 
-	virtual FString ToString() const override
-	{
-		FStringFormatNamedArguments Args;
-		Args.Add(TEXT("Id"), Id);
-		Args.Add(TEXT("DeviceIndex"), DeviceIndex);
-		Args.Add(TEXT("SensorIndex"), SensorIndex);
-		Args.Add(TEXT("SensorType"), SensorType);
-
-		return FString::Format(TEXT("{\"Id\": {Id}, \"DeviceIndex\": {DeviceIndex}, \"SensorIndex\": {SensorIndex}, \"SensorType\": \"{SensorType}\"}"), Args);
-	}
 };
 
 //Definition of Read Sensor request to Server. Currently unsupported.
@@ -1199,9 +948,10 @@ struct FBPSensorReadCommand : public FBPSensorMessageBase
 
 public:
 
+	static constexpr const ANSICHAR* MessageTitle = "SensorReadCmd";
+
 	FBPSensorReadCommand()
 	{
-		MessageTitle = "SensorReadCmd";
 		Id = -1;
 		DeviceIndex = -1;
 		SensorIndex = -1;
@@ -1210,7 +960,6 @@ public:
 
 	FBPSensorReadCommand(int32 InId, int32 InDeviceIndex, int32 InSensorIndex, FString InSensorType)
 	{
-		MessageTitle = "SensorReadCmd";
 		Id = InId;
 		DeviceIndex = InDeviceIndex;
 		SensorIndex = InSensorIndex;
@@ -1229,12 +978,13 @@ struct FBPSensorReading : public FBPSensorMessageBase
 
 public:
 
+	static constexpr const ANSICHAR* MessageTitle = "SensorReading";
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Meta = (Category = "ButtplugUE|Types"))
 	TArray<int32> Data;
 
 	FBPSensorReading()
 	{
-		MessageTitle = "SensorReading";
 		Id = -1;
 		DeviceIndex = -1;
 		SensorIndex = -1;
@@ -1244,7 +994,6 @@ public:
 
 	FBPSensorReading(int32 InId, int32 InDeviceIndex, int32 InSensorIndex, FString InSensorType, TArray<int32> InData)
 	{
-		MessageTitle = "SensorReading";
 		Id = InId;
 		DeviceIndex = InDeviceIndex;
 		SensorIndex = InSensorIndex;
@@ -1254,27 +1003,6 @@ public:
 
 	virtual ~FBPSensorReading() = default;
 
-	virtual FString ToString() const override
-	{
-		FStringFormatNamedArguments Args;
-		Args.Add(TEXT("Id"), Id);
-		Args.Add(TEXT("DeviceIndex"), DeviceIndex);
-		Args.Add(TEXT("SensorIndex"), SensorIndex);
-		Args.Add(TEXT("SensorType"), SensorType);
-		FString DataString = "[";
-		for (int i = 0; i < Data.Num(); i++)
-		{
-			DataString += FString::FromInt(Data[i]);
-			if (i != Data.Num() - 1)
-			{
-				DataString += ",";
-			}
-		}
-		DataString += "]";
-		Args.Add(TEXT("Data"), DataString);
-
-		return FString::Format(TEXT("{\"Id\": {Id}, \"DeviceIndex\": {DeviceIndex}, \"SensorIndex\": {SensorIndex}, \"SensorType\": \"{SensorType}\", \"Data\": {Data}}"), Args);
-	}
 };
 
 //Definition of SensorSubscription command to server. Current unsupported.
@@ -1285,9 +1013,10 @@ struct FBPSensorSubscribeCommand : public FBPSensorMessageBase
 
 public:
 
+	static constexpr const ANSICHAR* MessageTitle = "SensorSubscribeCmd";
+
 	FBPSensorSubscribeCommand()
 	{
-		MessageTitle = "SensorSubscribeCmd";
 		Id = -1;
 		DeviceIndex = -1;
 		SensorIndex = -1;
@@ -1296,7 +1025,6 @@ public:
 
 	FBPSensorSubscribeCommand(int32 InId, int32 InDeviceIndex, int32 InSensorIndex, FString InSensorType)
 	{
-		MessageTitle = "SensorSubscribeCmd";
 		Id = InId;
 		DeviceIndex = InDeviceIndex;
 		SensorIndex = InSensorIndex;
@@ -1315,9 +1043,10 @@ struct FBPSensorUnsubscribeCommand : public FBPSensorMessageBase
 
 public:
 
+	static constexpr const ANSICHAR* MessageTitle = "SensorUnsubscribeCmd";
+
 	FBPSensorUnsubscribeCommand()
 	{
-		MessageTitle = "SensorUnsubscribeCmd";
 		Id = -1;
 		DeviceIndex = -1;
 		SensorIndex = -1;
@@ -1326,7 +1055,6 @@ public:
 
 	FBPSensorUnsubscribeCommand(int32 InId, int32 InDeviceIndex, int32 InSensorIndex, FString InSensorType)
 	{
-		MessageTitle = "SensorUnsubscribeCmd";
 		Id = InId;
 		DeviceIndex = InDeviceIndex;
 		SensorIndex = InSensorIndex;
@@ -1337,6 +1065,13 @@ public:
 
 };
 
+//A message fresh off the wire, paired with its registry slot.
+struct FBPDecodedMessage
+{
+	EBPMessageType Type = EBPMessageType::MAX;
+	FInstancedStruct Message;
+};
+
 /**A selection of helpers for handling messages and types.*/
 UCLASS()
 class BUTTPLUGUE_API UBPTypes : public UBlueprintFunctionLibrary
@@ -1345,34 +1080,29 @@ class BUTTPLUGUE_API UBPTypes : public UBlueprintFunctionLibrary
 
 public:
 	
-	/*For packaging up a message of type T, optional context for logging purposes*/
-	template<typename T>
-	static FBPMessagePacket PackageMessage(const TOptional<UObject*> Context, T& Message)
-	{
-		FInstancedStruct RawMessage = FInstancedStruct::Make<T>(Message);
-		FBPMessagePacket Out = FBPMessagePacket();
-		Out.Messages.Add(RawMessage);
-		return Out;
-	};
-
-	/*For packaging up an array of messages of type T, optional context for logging purposes*/
-	template<typename T>
-	static FBPMessagePacket PackageMessage(const TOptional<UObject*> Context, TArray<T> Message)
-	{
-		FBPMessagePacket Out = FBPMessagePacket();
-		for (const T& Msg : Message)
-		{
-			FInstancedStruct RawMessage = FInstancedStruct::Make<T>(Msg);
-			Out.Messages.Add(RawMessage);
-		}
-		return Out;
-	};
-
 	/*For converting a received JSON from Intiface into a struct as defined in this header*/
 	static TArray<FInstancedStruct> DeserializeMessage(const TOptional<UObject*> Context, const FString& Message);
 
+	/*As above, parsing UTF-8 bytes directly in a single pass with no intermediate JSON DOM.
+	Decoded messages are appended to OutMessages along with their type, so callers can dispatch without looking it up again.*/
+	static void DeserializeMessage(const TOptional<UObject*> Context, TConstArrayView<uint8> Message, TArray<FBPDecodedMessage>& OutMessages);
+
+	/*As above, but only the title and Id of each message are read up front. The body is only decoded if ShouldDecode returns true for them,
+	otherwise it is skipped over and counted in OutSkipped.
+	Packets over the limits in ButtplugUESettings are rejected rather than decoded, the reason is returned. Never asserts on bad input.*/
+	static EBPInboundRejectReason DeserializeMessage(const TOptional<UObject*> Context, TConstArrayView<uint8> Message, TArray<FBPDecodedMessage>& OutMessages,
+									TFunctionRef<bool(EBPMessageType Type, int32 Id)> ShouldDecode, int32& OutSkipped);
+
 	/*Helper for getting the UScriptStruct based on its name in String form
 	Neccessary for the conversion from Intiface's unique way of packaging JSON.
+	Returns nullptr for message titles we do not know about.
 	*/
 	static UScriptStruct* GetStructType(const FString& Name);
+
+	/*Clamps an actuator value to 0...1 and snaps it to the nearest of the actuator's steps, as given by its StepCount.
+	Devices cannot act on anything finer, so this keeps packets short and makes repeated values compare equal.
+	A StepCount of 0 or less (not known) only clamps.
+	*/
+	UFUNCTION(BlueprintPure, Meta = (Category = "ButtplugUE|Types"))
+	static double QuantizeActuatorValue(double Value, int32 StepCount);
 };
@@ -35,8 +35,73 @@ public:
 	UPROPERTY(Config, EditAnywhere, meta = (AdvancedDisplay, Category = "ButtplugUE|Settings", ToolTip = "Whether the subsystem should automatically try to connect to Intiface during initialization. If this is set to false you will need to connect manually via 'Connect' on the BPDeviceSubsystem."))
 		bool bAutoConnect = true;
 
+	UPROPERTY(Config, EditAnywhere, meta = (AdvancedDisplay, Category = "ButtplugUE|Limits", ClampMin = "1024", ToolTip = "Largest packet accepted from Intiface, in bytes. Anything bigger is dropped unread."))
+		int32 MaxInboundPacketBytes = 1024 * 1024;
+
+	UPROPERTY(Config, EditAnywhere, meta = (AdvancedDisplay, Category = "ButtplugUE|Limits", ClampMin = "1", ToolTip = "Most elements decoded from any one array in a packet from Intiface (messages, devices, sensor data...)."))
+		int32 MaxInboundArrayLength = 4096;
+
+	UPROPERTY(Config, EditAnywhere, meta = (AdvancedDisplay, Category = "ButtplugUE|Limits", ClampMin = "4", ClampMax = "63", ToolTip = "Deepest JSON nesting accepted from Intiface. Real messages need about 8."))
+		int32 MaxInboundDepth = 16;
+
+	UPROPERTY(Config, EditAnywhere, meta = (AdvancedDisplay, Category = "ButtplugUE|Limits", ClampMin = "0", ToolTip = "Most received messages handed to delegates in one frame, the rest wait for the next. Spreads a burst of sensor readings over several frames. 0 for no limit."))
+		int32 MaxInboundMessagesPerFrame = 256;
+
+	UPROPERTY(Config, EditAnywhere, meta = (AdvancedDisplay, Category = "ButtplugUE|Limits", ClampMin = "0.5", ToolTip = "How long to wait for Intiface to answer a request before its Response delegate fires with an Error instead."))
+		float ResponseTimeoutSeconds = 10.0f;
+
+	UPROPERTY(Config, EditAnywhere, meta = (AdvancedDisplay, Category = "ButtplugUE|Settings", ToolTip = "When messages to Intiface are sent. Batched modes send everything issued in a frame as one packet, Immediate sends each message as it is issued. Read when the subsystem starts."))
+		EBPOutboundFlushMode OutboundFlushMode = EBPOutboundFlushMode::EndOfFrame;
+
+	UPROPERTY(Config, EditAnywhere, meta = (AdvancedDisplay, Category = "ButtplugUE|Settings", ToolTip = "In the batched flush modes, merge Scalar/Linear/Rotate commands for the same device within a frame into one, keeping the latest value per actuator. Commands with a Response bound are always sent as they are. Commands held back by bRateLimitDevices are merged like this whatever this is set to."))
+		bool bCoalesceCommands = true;
+
+	UPROPERTY(Config, EditAnywhere, meta = (AdvancedDisplay, Category = "ButtplugUE|Settings", ToolTip = "Drop Scalar/Linear/Rotate commands (without a Response bound) that would set an actuator to the value it was last sent, after snapping to its StepCount."))
+		bool bSuppressRedundantCommands = true;
+
+	UPROPERTY(Config, EditAnywhere, meta = (AdvancedDisplay, Category = "ButtplugUE|Settings", ClampMin = "0", EditCondition = "bSuppressRedundantCommands", ToolTip = "An unchanged value is still resent after this many seconds, in case the device lost it. 0 never resends."))
+		float RedundantCommandRefreshSeconds = 2.0f;
+
+	UPROPERTY(Config, EditAnywhere, meta = (AdvancedDisplay, Category = "ButtplugUE|Settings", ToolTip = "Hold Scalar/Linear/Rotate commands (without a Response bound) for a device until its DeviceMessageTimingGap has passed since the last one it was sent, then send only the newest value per actuator. Works in every flush mode."))
+		bool bRateLimitDevices = true;
+
+	UPROPERTY(Config, EditAnywhere, meta = (AdvancedDisplay, Category = "ButtplugUE|Settings", ClampMin = "0", EditCondition = "bRateLimitDevices", ToolTip = "Once this many commands to a device are waiting on their Ok, further ones are held (keeping only the newest) and the device is sent commands less often until replies speed up again. 0 turns this off."))
+		int32 MaxUnackedCommands = 4;
+
+	UPROPERTY(Config, EditAnywhere, meta = (AdvancedDisplay, Category = "ButtplugUE|Settings", ClampMin = "0.01", EditCondition = "bRateLimitDevices", ToolTip = "A device that was slowed down by MaxUnackedCommands speeds back up while its commands are answered within this many seconds."))
+		float CommandLatencyTargetSeconds = 0.25f;
+
+	UPROPERTY(Config, EditAnywhere, meta = (AdvancedDisplay, Category = "ButtplugUE|Limits", ClampMin = "1024", ToolTip = "A batched packet is sent early once it grows past this many bytes."))
+		int32 MaxOutboundPacketBytes = 64 * 1024;
+
+	UPROPERTY(Config, EditAnywhere, meta = (AdvancedDisplay, Category = "ButtplugUE|Caching", ClampMin = "0", ToolTip = "How long a Device List answer is reused for further Request Device List calls. Cleared whenever a device is added or removed. 0 turns caching off, identical requests in flight are still shared."))
+		float DeviceListCacheSeconds = 1.0f;
+
+	UPROPERTY(Config, EditAnywhere, meta = (AdvancedDisplay, Category = "ButtplugUE|Caching", ClampMin = "0", ToolTip = "How long a Server Info answer is reused for further Request Server Info calls. Cleared on disconnect. 0 turns caching off, identical requests in flight are still shared."))
+		float ServerInfoCacheSeconds = 60.0f;
+
+	UPROPERTY(Config, EditAnywhere, meta = (AdvancedDisplay, Category = "ButtplugUE|Caching", ClampMin = "0", ToolTip = "How long a Sensor Reading is reused for further reads of the same sensor (battery, RSSI...). 0 turns caching off, identical requests in flight are still shared."))
+		float SensorReadCacheSeconds = 0.5f;
+
 	static EBPLogVerbosity GetLoggingVerbosity();
 
+	static int32 GetMaxInboundPacketBytes();
+	static int32 GetMaxInboundArrayLength();
+	static int32 GetMaxInboundDepth();
+	static int32 GetMaxInboundMessagesPerFrame();
+	static float GetResponseTimeoutSeconds();
+	static EBPOutboundFlushMode GetOutboundFlushMode();
+	static int32 GetMaxOutboundPacketBytes();
+	static bool GetCoalesceCommands();
+	static bool GetSuppressRedundantCommands();
+	static float GetRedundantCommandRefreshSeconds();
+	static bool GetRateLimitDevices();
+	static int32 GetMaxUnackedCommands();
+	static float GetCommandLatencyTargetSeconds();
+
+	/*How long answers to a query type (RequestDeviceList, RequestServerInfo, SensorReadCmd) may be reused, 0 for anything else.*/
+	static float GetQueryCacheSeconds(EBPMessageType QueryType);
+
 	/*Gets the Server IP address.*/
 	UFUNCTION(BlueprintCallable, BlueprintPure, meta = (Category = "ButtplugUE|Settings"))
 		static FString GetButtplugServer();